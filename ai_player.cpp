@@ -1,33 +1,108 @@
 #include "ai_player.h"
-#include "game_engine.h"
+#include "game_core.h"
 #include "tank.h"
 #include "bullet.h"
 #include "game_map.h"
+#include "mcts_searcher.h"
+#include "minimax_searcher.h"
+#include "worker_pool.h"
+#include "endgame_table.h"
 #include <random>
 #include <algorithm>
 #include <climits>
-
-AIPlayer::AIPlayer(char tank_id, int difficulty) 
-    : ai_id(tank_id), difficulty_level(difficulty), edge_linger_turns(0) {
+#include <sstream>
+#include <iomanip>
+
+AIPlayer::AIPlayer(char tank_id, int difficulty, uint64_t seed) 
+    : ai_id(tank_id), difficulty_level(difficulty), edge_linger_turns(0),
+      rng_seed(seed), random_draws(0), endgame_moves(0) {
+    move_history.reserve(MOVE_HISTORY_LENGTH + 1);
+    restoreRandomState(0);
     if (difficulty_level < 1) difficulty_level = 1;
-    if (difficulty_level > 3) difficulty_level = 3;
+    if (difficulty_level > MAX_AI_LEVEL) difficulty_level = MAX_AI_LEVEL;
 }
 
 AIPlayer::~AIPlayer() {}
 
-Move AIPlayer::makeDecision(const GameEngine& game) {
-    AIState state = getGameState(game);
+static uint64_t nanosBetween(DecisionClock::time_point from, DecisionClock::time_point to) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count());
+}
+
+Move AIPlayer::makeDecision(const GameCore& game) {
+    DecisionClock::time_point start = DecisionClock::now();
+    Move move = decide(game, nullptr);
+    decision_stats.latency.record(nanosBetween(start, DecisionClock::now()));
+    return move;
+}
+
+Move AIPlayer::makeDecision(const GameCore& game, DecisionClock::time_point deadline) {
+    DecisionClock::time_point start = DecisionClock::now();
+    Move move = decide(game, &deadline);
+    DecisionClock::time_point end = DecisionClock::now();
+    decision_stats.latency.record(nanosBetween(start, end));
+    decision_stats.deadline_decisions++;
+    if (end > deadline) decision_stats.deadline_misses++;
+    return move;
+}
+
+Move AIPlayer::decide(const GameCore& game, const DecisionClock::time_point* deadline) {
+    Move move;
+    if (difficulty_level >= 2 && endgameMove(game, move)) return move;
+    if (difficulty_level < 4) {
+        getGameState(game, decision_state);
+        return makeDecision(decision_state);
+    }
+
+    // the level's own budget, cut short by the deadline if that comes first
+    SearchBudget budget = search_budget;
+    Move fallback = M_Forward;
+    int linger_turns = edge_linger_turns;
+    if (deadline) {
+        // the level-2 answer first, so that there is one whatever happens
+        getGameState(game, decision_state);
+        fallback = ruleMove(decision_state, 2);
+        int64_t left_us = std::chrono::duration_cast<std::chrono::microseconds>(*deadline - DecisionClock::now()).count();
+        left_us -= std::max<int64_t>(DEADLINE_RESERVE_US, left_us / 10);
+        if (left_us < 1000) { // SearchBudget counts whole milliseconds
+            decision_stats.fallbacks++;
+            recordMove(fallback);
+            return fallback;
+        }
+        int left_ms = static_cast<int>(std::min<int64_t>(left_us / 1000, INT_MAX));
+        budget.time_ms = (budget.time_ms > 0) ? std::min(budget.time_ms, left_ms) : left_ms;
+    }
+
+    bool ready;
+    move = (difficulty_level == 4) ? searchMove(game, budget, ready) : minimaxMove(game, budget, ready);
+    if (deadline && !ready) {
+        move = fallback;
+        decision_stats.fallbacks++;
+    } else {
+        edge_linger_turns = linger_turns; // the search keeps clear of the edge itself
+    }
+    recordMove(move);
+    return move;
+}
+
+Move AIPlayer::makeDecision(const AIState& state) {
+    Move chosen_move = ruleMove(state, difficulty_level);
+    recordMove(chosen_move);
+    return chosen_move;
+}
+
+// levels 1-3; level 2 is also what levels 4 and 5 play when a deadline leaves
+// them nothing better
+Move AIPlayer::ruleMove(const AIState& state, int level) {
     Move chosen_move;
 
     // move away from edge
     if (edge_linger_turns > 0) {
         chosen_move = moveTowardsCenter(state.my_pos, state.my_dir, state);
         edge_linger_turns--;
-        recordMove(chosen_move);
         return chosen_move;
     }
 
-    switch (difficulty_level) {
+    switch (level) {
         case 1: 
             chosen_move = makeRandomMove(); 
             if (willBeOutOfMap(state.current_bounds, getNextPosition(state.my_pos, state.my_dir, chosen_move))) {
@@ -42,16 +117,23 @@ Move AIPlayer::makeDecision(const GameEngine& game) {
     if (isNearMapEdge(state.current_bounds, getNextPosition(state.my_pos, state.my_dir, chosen_move))) {
         edge_linger_turns = 2;  // leave the border in time
     }
-
-    recordMove(chosen_move);
     return chosen_move;
 }
 
 Move AIPlayer::makeRandomMove() {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_int_distribution<> dis(0, 2);
-    return static_cast<Move>(dis(gen));
+    std::uniform_int_distribution<> dis(0, 2);
+    random_draws++;
+    return static_cast<Move>(dis(rng));
+}
+
+// reseed and replay the same number of draws as makeRandomMove made
+void AIPlayer::restoreRandomState(uint64_t draws) {
+    std::seed_seq seq{static_cast<uint32_t>(rng_seed), static_cast<uint32_t>(rng_seed >> 32),
+                      static_cast<uint32_t>(ai_id)};
+    rng.seed(seq);
+    std::uniform_int_distribution<> dis(0, 2);
+    for (uint64_t i = 0; i < draws; i++) dis(rng);
+    random_draws = draws;
 }
 
 Move AIPlayer::makeDefensiveMove(const AIState& state) {
@@ -60,7 +142,7 @@ Move AIPlayer::makeDefensiveMove(const AIState& state) {
     }
 
     // incline towards safe places away from the border
-    std::vector<Move> safe_moves;
+    MoveList safe_moves;
     for (Move move : getAllPossibleMoves()) {
         Position next_pos = getNextPosition(state.my_pos, state.my_dir, move);
         if (isSafePosition(state, next_pos) && !willBeInFutureDanger(state, next_pos)) {
@@ -81,13 +163,19 @@ Move AIPlayer::makeAggressiveMove(const AIState& state) {
         return findBestEscapeMove(state);
     }
 
-    Move attack_move = findBestAttackMove(state);
-    Position attack_pos = getNextPosition(state.my_pos, state.my_dir, attack_move);
-    if (canShootEnemy(state) && isSafePosition(state, attack_pos) && !willBeInFutureDanger(state, attack_pos)) {
-        return attack_move;
+    // keep firing, or take the first step of the shortest safe route to a firing line
+    Move attack_move = M_Forward;
+    bool attacking = canShootEnemy(state);
+    if (attacking) attack_move = findBestAttackMove(state);
+    else attacking = planner.planToFiringLine(state, attack_move);
+    if (attacking) {
+        Position attack_pos = getNextPosition(state.my_pos, state.my_dir, attack_move);
+        if (isSafePosition(state, attack_pos) && !willBeInFutureDanger(state, attack_pos)) {
+            return attack_move;
+        }
     }
 
-    std::vector<Move> valid_moves;
+    MoveList valid_moves;
     for (Move move : getAllPossibleMoves()) {
         Position next_pos = getNextPosition(state.my_pos, state.my_dir, move);
         if (isSafePosition(state, next_pos) && !willBeInFutureDanger(state, next_pos)) {
@@ -134,7 +222,7 @@ Move AIPlayer::makeBalancedMove(const AIState& state) {
     }
 
     // Priority 5: Move to safe position near center
-    std::vector<Move> good_moves;
+    MoveList good_moves;
     for (Move move : getAllPossibleMoves()) {
         Position next_pos = getNextPosition(state.my_pos, state.my_dir, move);
         if (isSafePosition(state, next_pos) && !willBeInFutureDanger(state, next_pos)) {
@@ -153,15 +241,9 @@ bool AIPlayer::isInDanger(const AIState& state) const {
     return !isSafePosition(state, state.my_pos) || willBeInFutureDanger(state, state.my_pos);
 }
 
+// a bullet lands there this turn or the next, before the tank can drive on
 bool AIPlayer::willBeHitByBullet(const AIState& state, const Position& next_pos) const {
-    for (const Position& bullet_pos : state.bullets) {
-        int dx = abs(bullet_pos.x - next_pos.x);
-        int dy = abs(bullet_pos.y - next_pos.y);
-        if ((dx <= BULLET_SPEED && dy == 0) || (dy <= BULLET_SPEED && dx == 0)) {
-            return true;
-        }
-    }
-    return false;
+    return state.danger.isHitWithin(next_pos.x, next_pos.y, 2);
 }
 
 bool AIPlayer::willBeOutOfMap(const MapBounds& bounds, const Position& next_pos) const {
@@ -170,10 +252,10 @@ bool AIPlayer::willBeOutOfMap(const MapBounds& bounds, const Position& next_pos)
 }
 
 bool AIPlayer::isNearMapEdge(const MapBounds& bounds, const Position& pos) const {
-    return (pos.x - bounds.min_x) <= SAFE_BORDER || 
-           (bounds.max_x - pos.x) <= SAFE_BORDER ||
-           (pos.y - bounds.min_y) <= SAFE_BORDER || 
-           (bounds.max_y - pos.y) <= SAFE_BORDER;
+    return (pos.x - bounds.min_x) <= weights.safe_border || 
+           (bounds.max_x - pos.x) <= weights.safe_border ||
+           (pos.y - bounds.min_y) <= weights.safe_border || 
+           (bounds.max_y - pos.y) <= weights.safe_border;
 }
 
 bool AIPlayer::willBeInFutureDanger(const AIState& state, const Position& pos) const {
@@ -181,9 +263,8 @@ bool AIPlayer::willBeInFutureDanger(const AIState& state, const Position& pos) c
            willBeOutOfMap(state.future_bounds, pos);
 }
 
-Move AIPlayer::findBestEscapeMove(const AIState& state) {
-    std::vector<Position> dangers = state.bullets;
-
+Move AIPlayer::findBestEscapeMove(const AIState& state) const {
+    PositionList dangers;
     if (isNearMapEdge(state.current_bounds, state.my_pos)) {
         dangers.emplace_back(state.current_bounds.min_x, state.my_pos.y);
         dangers.emplace_back(state.current_bounds.max_x, state.my_pos.y);
@@ -226,27 +307,30 @@ Move AIPlayer::moveTowardsTarget(const Position& current, const Position& target
     return M_Forward;
 }
 
-Move AIPlayer::moveTowardsCenter(const Position& current, Direction current_dir, const AIState& state) const {
+// along the shortest route that stays off bullets and on the shrinking map;
+// a single greedy step when there is none
+Move AIPlayer::moveTowardsCenter(const Position& current, Direction current_dir, const AIState& state) {
+    Move planned;
+    if (current == state.my_pos && current_dir == state.my_dir && planner.planToCenter(state, planned)) return planned;
     Position center(state.center_x, state.center_y);
     return moveTowardsTarget(current, center, current_dir);
 }
 
-Move AIPlayer::moveAwayFromDanger(const Position& current, const std::vector<Position>& dangers, 
+Move AIPlayer::moveAwayFromDanger(const Position& current, const PositionList& dangers, 
                                  Direction current_dir, const AIState& state) const {
-    std::vector<Move> moves = getAllPossibleMoves();
     int best_score = INT_MIN;
     Move best_move = M_Forward;
 
-    for (Move move : moves) {
+    for (Move move : getAllPossibleMoves()) {
         Position next_pos = getNextPosition(current, current_dir, move);
         if (willBeOutOfMap(state.future_bounds, next_pos)) continue;
         if (willBeOutOfMap(state.current_bounds, next_pos)) continue;
 
-        int score = 0;
+        int score = -weights.escape_landing * state.danger.hitCount(next_pos.x, next_pos.y, weights.future_turns);  // off bullet landings
         for (const Position& danger : dangers) {
-            score += calculateDistance(next_pos, danger) * 2;  // far from danger: 2 points
+            score += calculateDistance(next_pos, danger) * weights.escape_border;  // far from the borders
         }
-        score -= calculateDistance(next_pos, Position(state.center_x, state.center_y)) * 3;  // near center: 3 points
+        score -= calculateDistance(next_pos, Position(state.center_x, state.center_y)) * weights.escape_center;  // near center
 
         if (score > best_score) {
             best_score = score;
@@ -257,8 +341,13 @@ Move AIPlayer::moveAwayFromDanger(const Position& current, const std::vector<Pos
     return best_move;
 }
 
-AIState AIPlayer::getGameState(const GameEngine& game) const {
+AIState AIPlayer::getGameState(const GameCore& game) const {
     AIState state;
+    getGameState(game, state);
+    return state;
+}
+
+void AIPlayer::getGameState(const GameCore& game, AIState& state) const {
     const Tank& my_tank = game.getTankById(ai_id);
     const Tank& enemy_tank = game.getOtherTank(ai_id);
     const GameMap& map = game.getGameMap();
@@ -282,18 +371,19 @@ AIState AIPlayer::getGameState(const GameEngine& game) const {
         map.getMaxY()
     );
 
-    state.future_bounds = predictFutureBounds(game, FUTURE_TURNS);
+    state.future_bounds = predictFutureBounds(game, weights.future_turns);
 
-    for (const auto& bullet : game.getBullets()) {
-        if (bullet->isActive()) {
-            state.bullets.push_back(Position(bullet->getX(), bullet->getY()));
-        }
+    state.bullets.clear();
+    state.danger.clear();
+    for (const Bullet& bullet : game.getBullets()) {
+        if (!bullet.isActive()) continue;
+        state.bullets.emplace_back(Position(bullet.getX(), bullet.getY()), bullet.getDirection(), bullet.getOwnerId());
+        if (bullet.getOwnerId() != ai_id) state.danger.addBullet(bullet.getX(), bullet.getY(), bullet.getDirection());
     }
-
-    return state;
+    state.danger.project();
 }
 
-MapBounds AIPlayer::predictFutureBounds(const GameEngine& game, int future_turns) const {
+MapBounds AIPlayer::predictFutureBounds(const GameCore& game, int future_turns) const {
     const GameMap& current_map = game.getGameMap();
     int current_size = current_map.getCurrentSize();
     int current_turn = game.getCurrentTurn();
@@ -346,32 +436,31 @@ int AIPlayer::calculateDistance(const Position& a, const Position& b) const {
 
 int AIPlayer::evaluatePosition(const AIState& state, const Position& pos) const {
     int score = 0;
-    score += calculateDistance(pos, state.enemy_pos) * 1; // 1. far from the enemy
-    score -= calculateDistance(pos, Position(state.center_x, state.center_y)) * 4; // 2. near the center
+    score += calculateDistance(pos, state.enemy_pos) * weights.enemy_distance; // 1. far from the enemy
+    score -= calculateDistance(pos, Position(state.center_x, state.center_y)) * weights.center_distance; // 2. near the center
 
-    // 3. far from the bullet
-    for (const Position& bullet : state.bullets) {
-        int dist = calculateDistance(pos, bullet);
-        if (dist < 4) score -= (4 - dist) * 10;
+    // 3. off the cells bullets land on, the sooner the worse
+    for (int turn = 1; turn <= weights.future_turns; turn++) {
+        if (state.danger.isHit(turn, pos.x, pos.y)) score -= (weights.future_turns + 1 - turn) * weights.landing;
     }
 
     // 4. far from the current edge
     if (isNearMapEdge(state.current_bounds, pos)) {
         int edge_penalty = 0;
-        edge_penalty += (SAFE_BORDER - (pos.x - state.current_bounds.min_x)) * 20;
-        edge_penalty += (SAFE_BORDER - (state.current_bounds.max_x - pos.x)) * 20;
-        edge_penalty += (SAFE_BORDER - (pos.y - state.current_bounds.min_y)) * 20;
-        edge_penalty += (SAFE_BORDER - (state.current_bounds.max_y - pos.y)) * 20;
+        edge_penalty += (weights.safe_border - (pos.x - state.current_bounds.min_x)) * weights.edge;
+        edge_penalty += (weights.safe_border - (state.current_bounds.max_x - pos.x)) * weights.edge;
+        edge_penalty += (weights.safe_border - (pos.y - state.current_bounds.min_y)) * weights.edge;
+        edge_penalty += (weights.safe_border - (state.current_bounds.max_y - pos.y)) * weights.edge;
         score -= edge_penalty;
     }
 
     // 5. far from the future edge
     if (isNearMapEdge(state.future_bounds, pos)) {
         int future_penalty = 0;
-        future_penalty += (SAFE_BORDER - (pos.x - state.future_bounds.min_x)) * 15;
-        future_penalty += (SAFE_BORDER - (state.future_bounds.max_x - pos.x)) * 15;
-        future_penalty += (SAFE_BORDER - (pos.y - state.future_bounds.min_y)) * 15;
-        future_penalty += (SAFE_BORDER - (state.future_bounds.max_y - pos.y)) * 15;
+        future_penalty += (weights.safe_border - (pos.x - state.future_bounds.min_x)) * weights.future_edge;
+        future_penalty += (weights.safe_border - (state.future_bounds.max_x - pos.x)) * weights.future_edge;
+        future_penalty += (weights.safe_border - (pos.y - state.future_bounds.min_y)) * weights.future_edge;
+        future_penalty += (weights.safe_border - (state.future_bounds.max_y - pos.y)) * weights.future_edge;
         score -= future_penalty;
     }
 
@@ -379,14 +468,85 @@ int AIPlayer::evaluatePosition(const AIState& state, const Position& pos) const
 }
 
 void AIPlayer::setDifficultyLevel(int level) {
-    if (level >= 1 && level <= 3) {
+    if (level >= 1 && level <= MAX_AI_LEVEL) {
         difficulty_level = level;
     }
 }
 
+// level 4; the seed depends on the turn so that replays and the ponderer agree
+Move AIPlayer::searchMove(const GameCore& game, const SearchBudget& budget, bool& ready) {
+    if (!searcher) searcher = std::make_shared<MctsSearcher>();
+    uint64_t seed = rng_seed * 0x9E3779B97F4A7C15ULL + static_cast<uint64_t>(game.getCurrentTurn()) * 2 + (ai_id == 'B');
+    Move chosen_move = searcher->search(game, ai_id, budget, seed);
+    uint64_t enough = (budget.playouts > 0) ? std::min(budget.playouts, MIN_READY_PLAYOUTS) : MIN_READY_PLAYOUTS;
+    ready = searcher->getLastPlayouts() >= enough;
+    return chosen_move;
+}
+
+// level 5; no randomness, the heuristic only orders the first pass, and the
+// threads only change how fast the move is found
+Move AIPlayer::minimaxMove(const GameCore& game, const SearchBudget& budget, bool& ready) {
+    if (!minimax) minimax = std::make_shared<MinimaxSearcher>();
+    getGameState(game, decision_state);
+    int hint[3];
+    for (int m = 0; m < 3; m++) hint[m] = scoreMove(decision_state, static_cast<Move>(m));
+    int threads = std::min(budget.threads, MAX_SEARCH_THREADS);
+    if (threads > 1 && (!pool || pool->getThreads() != threads)) pool = std::make_shared<WorkerPool>(threads);
+    uint64_t passes = minimax->getStats().iterations;
+    Move chosen_move = minimax->search(game, ai_id, budget, hint, (threads > 1) ? pool.get() : nullptr);
+    // a pass the deadline cut short is not trusted, so no pass is no move
+    ready = minimax->getStats().iterations > passes;
+    return chosen_move;
+}
+
+// perfect play from the tablebase, no search; among moves of equal value the
+// heuristic picks, so that a drawn endgame is still played sensibly
+bool AIPlayer::endgameMove(const GameCore& game, Move& move) {
+    int8_t values[3];
+    if (!endgame || !endgame->probe(game, ai_id, values)) return false;
+
+    getGameState(game, decision_state);
+    int best_rank = INT_MIN, best_score = INT_MIN;
+    for (int m = 0; m < 3; m++) {
+        if (values[m] == EndgameTable::ILLEGAL) continue;
+        int rank = EndgameTable::rank(values[m]);
+        int score = scoreMove(decision_state, static_cast<Move>(m));
+        if (rank > best_rank || (rank == best_rank && score > best_score)) {
+            best_rank = rank;
+            best_score = score;
+            move = static_cast<Move>(m);
+        }
+    }
+    edge_linger_turns = 0;
+    endgame_moves++;
+    recordMove(move);
+    return true;
+}
+
+void DecisionStats::merge(const DecisionStats& other) {
+    latency.merge(other.latency);
+    deadline_decisions += other.deadline_decisions;
+    deadline_misses += other.deadline_misses;
+    fallbacks += other.fallbacks;
+}
+
+std::string DecisionStats::getSummary(const std::string& name) const {
+    const double us = 1000.0;
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1) << "=== " << name << ": " << latency.getCount() << " decisions, p50 "
+       << latency.getPercentile(0.50) / us << " us, p99 " << latency.getPercentile(0.99) / us << " us, max "
+       << latency.getMax() / us << " us";
+    if (deadline_decisions > 0) {
+        ss << " | " << deadline_decisions << " with a deadline, " << deadline_misses << " missed it, "
+           << fallbacks << " fell back to level 2";
+    }
+    ss << " ===";
+    return ss.str();
+}
+
 void AIPlayer::recordMove(Move move) {
     move_history.push_back(move);
-    if (move_history.size() > 10) {
+    if (move_history.size() > MOVE_HISTORY_LENGTH) {
         move_history.erase(move_history.begin());
     }
 }
@@ -402,11 +562,15 @@ bool AIPlayer::isRepeatingMoves() const {
            move_history[recent_size-2] == move_history[recent_size-4];
 }
 
-std::vector<Move> AIPlayer::getAllPossibleMoves() const {
-    return {M_Forward, M_Left, M_Right};
+MoveList AIPlayer::getAllPossibleMoves() const {
+    MoveList moves;
+    moves.push_back(M_Forward);
+    moves.push_back(M_Left);
+    moves.push_back(M_Right);
+    return moves;
 }
 
-Move AIPlayer::selectBestMove(const std::vector<Move>& moves, const AIState& state) const {
+Move AIPlayer::selectBestMove(const MoveList& moves, const AIState& state) const {
     if (moves.empty()) return M_Forward;
 
     int best_score = INT_MIN;
@@ -451,26 +615,16 @@ bool AIPlayer::isSafePosition(const AIState& state, const Position& pos) const {
 // New smarter AI functions
 
 bool AIPlayer::isInBulletPath(const AIState& state) const {
-    // Check if current position is in the path of any bullet
-    for (const Position& bullet : state.bullets) {
-        // Check if bullet is moving towards us (same row or column)
-        if (bullet.x == state.my_pos.x || bullet.y == state.my_pos.y) {
-            int dist = calculateDistance(bullet, state.my_pos);
-            if (dist <= BULLET_SPEED * 2) {  // Within 2 turns of bullet travel
-                return true;
-            }
-        }
-    }
-    return false;
+    // a bullet lands on us within 2 turns if we stay
+    return state.danger.isHitWithin(state.my_pos.x, state.my_pos.y, 2);
 }
 
 Move AIPlayer::findDodgeMove(const AIState& state) const {
     // Find the best move to dodge incoming bullets
-    std::vector<Move> moves = getAllPossibleMoves();
     int best_score = INT_MIN;
     Move best_move = M_Forward;
     
-    for (Move move : moves) {
+    for (Move move : getAllPossibleMoves()) {
         Position next_pos = getNextPosition(state.my_pos, state.my_dir, move);
         
         // Skip if move goes out of bounds
@@ -479,31 +633,20 @@ Move AIPlayer::findDodgeMove(const AIState& state) const {
         
         int score = 0;
         
-        // Check if this position avoids all bullets
-        bool avoids_bullets = true;
-        for (const Position& bullet : state.bullets) {
-            // Calculate if bullet will hit this position
-            int dx = abs(bullet.x - next_pos.x);
-            int dy = abs(bullet.y - next_pos.y);
-            
-            // If bullet is on same row/column and within range
-            if ((dx == 0 && dy <= BULLET_SPEED * 2) || 
-                (dy == 0 && dx <= BULLET_SPEED * 2)) {
-                avoids_bullets = false;
-                score -= 50;  // Penalize positions in bullet path
-            }
-        }
+        // Penalize the turns a bullet lands on this position
+        int hits = state.danger.hitCount(next_pos.x, next_pos.y, 2);
+        score -= hits * weights.dodge_hit;
         
-        if (avoids_bullets) {
-            score += 100;  // Big bonus for avoiding bullets
+        if (hits == 0) {
+            score += weights.dodge_clear;  // Big bonus for avoiding bullets
         }
         
         // Prefer staying near center
-        score -= calculateDistance(next_pos, Position(state.center_x, state.center_y));
+        score -= calculateDistance(next_pos, Position(state.center_x, state.center_y)) * weights.dodge_center;
         
         // Prefer positions away from edges
         if (isNearMapEdge(state.current_bounds, next_pos)) {
-            score -= 30;
+            score -= weights.dodge_edge;
         }
         
         if (score > best_score) {
@@ -554,3 +697,23 @@ Move AIPlayer::findPositioningMove(const AIState& state) const {
     
     return M_Forward;
 }
+
+// tanks side by side on the last 2x2 map cannot hit each other, hence the cap
+GameResult playAIMatch(GameCore& core, AIPlayer& ai_a, AIPlayer& ai_b, int deadline_ms) {
+    AIPlayer* players[2] = {&ai_a, &ai_b};
+    const char ids[2] = {'A', 'B'};
+    while (core.getCurrentTurn() < MAX_AI_MATCH_TURNS) {
+        core.beginTurn();
+        for (int i = 0; i < 2; i++) {
+            Move move = (deadline_ms > 0)
+                ? players[i]->makeDecision(core, DecisionClock::now() + std::chrono::milliseconds(deadline_ms))
+                : players[i]->makeDecision(core);
+            core.applyMove(ids[i], move);
+        }
+        if (core.checkTankCollision()) return core.checkGameEnd();
+        core.finishTurn();
+        GameResult result = core.checkGameEnd();
+        if (result != GAME_CONTINUE) return result;
+    }
+    return DRAW;
+}
@@ -2,10 +2,49 @@
 #define AI_PLAYER_H
 #include "common.h"
 #include <vector>
+#include <random>
+#include <cstdint>
+#include <memory>
+#include <chrono>
+#include <string>
+#include "search_budget.h"
+#include "turn_profiler.h"
+#include "danger_map.h"
+#include "route_planner.h"
+#include "fixed_list.h"
+#include "ai_weights.h"
 
-class GameEngine; 
+class GameCore;
 class Tank;
 class Bullet;
+class MctsSearcher;
+class MinimaxSearcher;
+class WorkerPool;
+class EndgameTable;
+
+const int MAX_AI_LEVEL = 5; // 4: Monte-Carlo tree search, 5: minimax
+
+// With a deadline, levels 4 and 5 search within their SearchBudget until a
+// tenth of the time before it, at least this long: what a search may take to
+// notice and return, or lose to the scheduler. Levels 1-3 and the endgame
+// table answer in microseconds and ignore it.
+const int DEADLINE_RESERVE_US = 500;
+// fewer level-4 playouts than this is noise: the level-2 move is played instead
+const int MIN_READY_PLAYOUTS = 64;
+
+typedef std::chrono::steady_clock DecisionClock;
+
+// how long decisions on the game took, and how those given a deadline went
+struct DecisionStats {
+    LatencyHistogram latency;    // nanoseconds, every makeDecision(game)
+    uint64_t deadline_decisions;
+    uint64_t deadline_misses;    // returned after the deadline
+    uint64_t fallbacks;          // the search had nothing ready, level 2 answered
+
+    DecisionStats() : deadline_decisions(0), deadline_misses(0), fallbacks(0) {}
+    void merge(const DecisionStats& other);
+    std::string getSummary(const std::string& name) const;
+};
 
 struct Position {
     int x, y;
@@ -24,6 +63,17 @@ struct MapBounds {
         : min_x(min_x), max_x(max_x), min_y(min_y), max_y(max_y) {}
 };
 
+struct AIBullet {
+    Position pos;
+    Direction dir;
+    char owner_id;
+    AIBullet(const Position& pos = Position(), Direction dir = D_Left, char owner_id = 'A')
+        : pos(pos), dir(dir), owner_id(owner_id) {}
+};
+
+typedef FixedList<AIBullet, MAX_LIVE_BULLETS + 1> BulletList; // + 1: the ponderer adds the enemy's next shot
+typedef FixedList<Position, 8> PositionList;                    // the border points of an escape
+
 struct AIState {
     Position my_pos;
     Position enemy_pos;
@@ -31,7 +81,8 @@ struct AIState {
     Direction enemy_dir;
     int my_life;
     int enemy_life;
-    std::vector<Position> bullets;
+    BulletList bullets;        // in the engine's order
+    DangerMap danger;          // landing cells of the enemy's bullets, turn by turn
     int map_size;
     int turn_count;
     MapBounds current_bounds;  
@@ -41,19 +92,40 @@ struct AIState {
     int shrink_interval;       
 };
 
+// candidate moves of one decision; never more than three
+typedef FixedList<Move, 3> MoveList;
+
 class AIPlayer {
 private:
     char ai_id;
     int difficulty_level;
     std::vector<Move> move_history;
-    static const int SAFE_BORDER = 3;  
-    static const int FUTURE_TURNS = 3; 
+    static const size_t MOVE_HISTORY_LENGTH = 10;
+    AIWeights weights;  // of the rule-based levels; also orders level 5's first pass
+    // reused by every decision so that a turn does not allocate
+    AIState decision_state;
     int edge_linger_turns;  // to move away from edge
+    std::mt19937 rng;  // seeded so that recorded games are reproducible
+    uint64_t rng_seed;
+    uint64_t random_draws; // lets a checkpoint restore the generator without its full state
+    RoutePlanner planner;  // routes to the center, and at level 3 to a firing line
+    SearchBudget search_budget;
+    // shared so that copies keep one node pool or table; only used at levels 4 and 5
+    std::shared_ptr<MctsSearcher> searcher;
+    std::shared_ptr<MinimaxSearcher> minimax;
+    std::shared_ptr<WorkerPool> pool; // level 5 with search_budget.threads > 1, started once
+    std::shared_ptr<const EndgameTable> endgame; // levels 2 and up play from it once it covers the board
+    uint64_t endgame_moves;
+    DecisionStats decision_stats;
 
 public:
-    AIPlayer(char tank_id, int difficulty = 2);
+    AIPlayer(char tank_id, int difficulty = 2, uint64_t seed = 0);
     ~AIPlayer();
-    Move makeDecision(const GameEngine& game);
+    Move makeDecision(const GameCore& game);
+    // returns by the deadline: the best move the search has found by then, or
+    // the level-2 move if it has none yet
+    Move makeDecision(const GameCore& game, DecisionClock::time_point deadline);
+    Move makeDecision(const AIState& state);
     
     Move makeRandomMove();
     Move makeDefensiveMove(const AIState& state);
@@ -68,14 +140,16 @@ public:
     bool willBeInFutureDanger(const AIState& state, const Position& pos) const;
     
     // decide where to move
-    Move findBestEscapeMove(const AIState& state);
+    Move findBestEscapeMove(const AIState& state) const;
     Move findBestAttackMove(const AIState& state) const;
     Move moveTowardsTarget(const Position& current, const Position& target, Direction current_dir) const;
-    Move moveAwayFromDanger(const Position& current, const std::vector<Position>& dangers, 
+    Move moveAwayFromDanger(const Position& current, const PositionList& dangers, 
                            Direction current_dir, const AIState& state) const;
-    Move moveTowardsCenter(const Position& current, Direction current_dir, const AIState& state) const;
+    Move moveTowardsCenter(const Position& current, Direction current_dir, const AIState& state);
     
-    AIState getGameState(const GameEngine& game) const;
+    AIState getGameState(const GameCore& game) const;
+    // refills state in place; nothing in it allocates
+    void getGameState(const GameCore& game, AIState& state) const;
     Position getNextPosition(const Position& current, Direction dir, Move move) const;
     Direction getNextDirection(Direction current_dir, Move move) const;
     int calculateDistance(const Position& a, const Position& b) const;
@@ -84,22 +158,54 @@ public:
     char getAIId() const { return ai_id; }
     int getDifficultyLevel() const { return difficulty_level; }
     void setDifficultyLevel(int level);
+    const SearchBudget& getSearchBudget() const { return search_budget; }
+    void setSearchBudget(const SearchBudget& budget) { search_budget = budget; }
+    const AIWeights& getWeights() const { return weights; }
+    void setWeights(const AIWeights& new_weights) { weights = new_weights; }
+    const EndgameTable* getEndgameTable() const { return endgame.get(); }
+    void setEndgameTable(const std::shared_ptr<const EndgameTable>& table) { endgame = table; }
+    uint64_t getEndgameMoves() const { return endgame_moves; }
+    const DecisionStats& getDecisionStats() const { return decision_stats; }
+    const MctsSearcher* getSearcher() const { return searcher.get(); }
+    const MinimaxSearcher* getMinimax() const { return minimax.get(); }
+    const RoutePlanner& getPlanner() const { return planner; }
     
     void recordMove(Move move);
     void clearHistory();
     bool isRepeatingMoves() const;
+    
+    // checkpoint support
+    const std::vector<Move>& getMoveHistory() const { return move_history; }
+    void setMoveHistory(const std::vector<Move>& history) { move_history = history; }
+    int getEdgeLingerTurns() const { return edge_linger_turns; }
+    void setEdgeLingerTurns(int turns) { edge_linger_turns = turns; }
+    uint64_t getRandomDraws() const { return random_draws; }
+    void restoreRandomState(uint64_t draws);
 
 private:
-    std::vector<Move> getAllPossibleMoves() const;
-    Move selectBestMove(const std::vector<Move>& moves, const AIState& state) const;
+    MoveList getAllPossibleMoves() const;
+    Move selectBestMove(const MoveList& moves, const AIState& state) const;
     int scoreMove(const AIState& state, Move move) const;
     bool canShootEnemy(const AIState& state) const;
     bool isSafePosition(const AIState& state, const Position& pos) const;
-    MapBounds predictFutureBounds(const GameEngine& game, int future_turns) const;
+    MapBounds predictFutureBounds(const GameCore& game, int future_turns) const;
     
     // Smarter AI helper functions
     bool isInBulletPath(const AIState& state) const;
     Move findDodgeMove(const AIState& state) const;
     Move findPositioningMove(const AIState& state) const;
+    Move decide(const GameCore& game, const DecisionClock::time_point* deadline);
+    Move ruleMove(const AIState& state, int level);
+    // ready: the search found something worth more than the heuristic
+    Move searchMove(const GameCore& game, const SearchBudget& budget, bool& ready);
+    Move minimaxMove(const GameCore& game, const SearchBudget& budget, bool& ready);
+    bool endgameMove(const GameCore& game, Move& move);
 };
+
+// one match between two AIs straight on the rules, the engine's turn order
+// without its front end, from wherever core stands; a draw after MAX_AI_MATCH_TURNS.
+// deadline_ms > 0 gives every decision that long
+const int MAX_AI_MATCH_TURNS = 500;
+GameResult playAIMatch(GameCore& core, AIPlayer& ai_a, AIPlayer& ai_b, int deadline_ms = 0);
+
 #endif // AI_PLAYER_H
\ No newline at end of file
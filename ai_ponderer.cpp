@@ -0,0 +1,88 @@
+// ai_ponderer.cpp
+
+#include "ai_ponderer.h"
+#include <chrono>
+#include <sstream>
+
+AIPonderer::AIPonderer()
+    : pending(false), replies_used(0), replies_waited(0), wait_us(0) {
+}
+
+AIPonderer::~AIPonderer() {
+    cancel();
+}
+
+void AIPonderer::start(const AIPlayer& ai, const AIState& state, const Tank& enemy_tank) {
+    cancel();
+
+    // everything the worker touches is copied here, on the game thread
+    for (int i = 0; i < 3; i++) {
+        replies[i].player = std::make_unique<AIPlayer>(ai);
+        replies[i].move = M_Forward;
+    }
+    base_state = state;
+    enemy = std::make_unique<Tank>(enemy_tank);
+    pending = true;
+    worker = std::thread(&AIPonderer::run, this);
+}
+
+bool AIPonderer::take(Move enemy_move, AIPlayer& ai, Move& reply) {
+    if (!pending) return false;
+
+    if (worker.joinable()) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        worker.join();
+        int64_t waited = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        // a join on a finished thread takes a few microseconds at most
+        if (waited > 50) replies_waited++;
+        wait_us += waited;
+    }
+    pending = false;
+
+    Reply& chosen = replies[enemy_move];
+    ai = *chosen.player;
+    reply = chosen.move;
+    replies_used++;
+    return true;
+}
+
+void AIPonderer::cancel() {
+    if (worker.joinable()) worker.join(); // the search is bounded, so just let it finish
+    pending = false;
+}
+
+void AIPonderer::run() {
+    const Move moves[3] = {M_Forward, M_Left, M_Right};
+    for (int i = 0; i < 3; i++) {
+        AIState state = predictState(base_state, *enemy, moves[i]);
+        replies[moves[i]].move = replies[moves[i]].player->makeDecision(state);
+    }
+}
+
+AIState AIPonderer::predictState(const AIState& state, const Tank& enemy_tank, Move enemy_move) {
+    // same steps as GameCore::applyMove
+    Tank moved(enemy_tank);
+    moved.move(enemy_move);
+    moved.updateShootCounter();
+
+    AIState next = state;
+    next.enemy_pos = Position(moved.getX(), moved.getY());
+    next.enemy_dir = moved.getDirection();
+    if (moved.canShoot()) {
+        int bullet_x, bullet_y;
+        moved.getBulletSpawnPosition(bullet_x, bullet_y);
+        next.bullets.push_back(AIBullet(Position(bullet_x, bullet_y), moved.getDirection(), moved.getTankId()));
+        next.danger.addBullet(bullet_x, bullet_y, moved.getDirection());
+        next.danger.project();
+    }
+    return next;
+}
+
+std::string AIPonderer::getSummary() const {
+    std::stringstream ss;
+    ss << "AI pondering: " << replies_used << " replies, "
+       << replies_waited << " waited for the search";
+    if (replies_used > 0) ss << ", " << wait_us / replies_used << " us avg wait";
+    return ss.str();
+}
@@ -0,0 +1,61 @@
+// ai_ponderer.h
+
+#ifndef AI_PONDERER_H
+#define AI_PONDERER_H
+
+#include <thread>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include "common.h"
+#include "ai_player.h"
+#include "tank.h"
+
+// Lets the PVE AI think while the human is still choosing. When the prompt
+// goes up, copies of the AI work out their reply to each of the three moves
+// the human can make, on a background thread. Once the real move is known
+// the matching copy, with its history and random state, replaces the AI and
+// its reply is used as is, so the game plays exactly as without pondering.
+// The engine does not start it once an endgame table may apply, since the
+// copies only see the AIState and could not probe the table.
+class AIPonderer {
+private:
+    struct Reply {
+        std::unique_ptr<AIPlayer> player;
+        Move move;
+    };
+
+    Reply replies[3]; // indexed by the human's move
+    AIState base_state;
+    std::unique_ptr<Tank> enemy;
+    std::thread worker;
+    bool pending;
+
+    int replies_used;
+    int replies_waited; // the human was faster than the search
+    int64_t wait_us;
+
+public:
+    AIPonderer();
+    ~AIPonderer();
+
+    AIPonderer(const AIPonderer&) = delete;
+    AIPonderer& operator=(const AIPonderer&) = delete;
+
+    // state is the AI's view before the enemy moves
+    void start(const AIPlayer& ai, const AIState& state, const Tank& enemy_tank);
+    // installs the pondered AI for enemy_move into ai; false if nothing was pondered
+    bool take(Move enemy_move, AIPlayer& ai, Move& reply);
+    void cancel();
+    bool isPending() const { return pending; }
+
+    std::string getSummary() const;
+
+    // the AI's view after the enemy makes enemy_move, including a bullet it fires
+    static AIState predictState(const AIState& state, const Tank& enemy_tank, Move enemy_move);
+
+private:
+    void run();
+};
+
+#endif // AI_PONDERER_H
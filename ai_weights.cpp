@@ -0,0 +1,97 @@
+// ai_weights.cpp
+
+#include "ai_weights.h"
+#include "danger_map.h"
+#include <fstream>
+#include <sstream>
+
+// the numbers the AI was written with
+AIWeights::AIWeights()
+    : enemy_distance(1), center_distance(4), landing(10), edge(20), future_edge(15),
+      escape_landing(40), escape_border(2), escape_center(3),
+      dodge_clear(100), dodge_hit(50), dodge_center(1), dodge_edge(30),
+      safe_border(3), future_turns(DangerMap::TURNS) {
+}
+
+bool AIWeights::operator==(const AIWeights& other) const {
+    for (const AIWeightInfo& info : AI_WEIGHT_INFO) {
+        if (this->*info.field != other.*info.field) return false;
+    }
+    return true;
+}
+
+// wide enough to turn a term off or let it outweigh the others
+const AIWeightInfo AI_WEIGHT_INFO[AI_WEIGHT_COUNT] = {
+    {"enemy_distance",  &AIWeights::enemy_distance,  0, 20},
+    {"center_distance", &AIWeights::center_distance, 0, 40},
+    {"landing",         &AIWeights::landing,         0, 100},
+    {"edge",            &AIWeights::edge,            0, 200},
+    {"future_edge",     &AIWeights::future_edge,     0, 200},
+    {"escape_landing",  &AIWeights::escape_landing,  0, 400},
+    {"escape_border",   &AIWeights::escape_border,   0, 20},
+    {"escape_center",   &AIWeights::escape_center,   0, 30},
+    {"dodge_clear",     &AIWeights::dodge_clear,     0, 1000},
+    {"dodge_hit",       &AIWeights::dodge_hit,       0, 500},
+    {"dodge_center",    &AIWeights::dodge_center,    0, 20},
+    {"dodge_edge",      &AIWeights::dodge_edge,      0, 300},
+    {"safe_border",     &AIWeights::safe_border,     0, INITIAL_MAP_SIZE / 2 - 2},
+    {"future_turns",    &AIWeights::future_turns,    1, DangerMap::TURNS},
+};
+
+static const AIWeightInfo* findWeight(const std::string& name) {
+    for (const AIWeightInfo& info : AI_WEIGHT_INFO) {
+        if (name == info.name) return &info;
+    }
+    return nullptr;
+}
+
+bool loadAIWeights(const std::string& filename, AIWeights& weights, std::string& error) {
+    std::ifstream in(filename);
+    if (!in) {
+        error = filename + ": cannot read file";
+        return false;
+    }
+
+    AIWeights loaded = weights;
+    std::string text;
+    for (int line = 1; std::getline(in, text); line++) {
+        size_t comment = text.find('#');
+        if (comment != std::string::npos) text.erase(comment);
+
+        std::istringstream fields(text);
+        std::string name, rest;
+        int value;
+        if (!(fields >> name)) continue;
+        const AIWeightInfo* info = findWeight(name);
+        std::string where = filename + ":" + std::to_string(line) + ": ";
+        if (!info) {
+            error = where + "unknown weight '" + name + "'";
+            return false;
+        }
+        if (!(fields >> value) || (fields >> rest)) {
+            error = where + name + " needs one number";
+            return false;
+        }
+        if (value < info->min_value || value > info->max_value) {
+            error = where + name + " must be " + std::to_string(info->min_value) + "-" + std::to_string(info->max_value);
+            return false;
+        }
+        loaded.*info->field = value;
+    }
+
+    weights = loaded;
+    return true;
+}
+
+bool saveAIWeights(const std::string& filename, const AIWeights& weights, const std::string& header) {
+    std::ofstream out(filename);
+    if (!out) return false;
+
+    std::istringstream lines(header);
+    std::string line;
+    while (std::getline(lines, line)) out << "# " << line << "\n";
+    for (const AIWeightInfo& info : AI_WEIGHT_INFO) {
+        out << info.name << " " << weights.*info.field << "\n";
+    }
+    return static_cast<bool>(out.flush());
+}
@@ -0,0 +1,59 @@
+// ai_weights.h
+
+#ifndef AI_WEIGHTS_H
+#define AI_WEIGHTS_H
+
+#include <string>
+
+// The numbers behind the rule-based levels (2 and 3): how much each thing
+// counts when a move is scored, and how far ahead they look. tankwar-tune
+// searches for better ones by self-play and saves them as plain text, one
+// "name value" per line with # comments, which --ai-weights loads:
+//
+//   # tankwar-tune, 200 iterations
+//   center_distance 5
+//   safe_border 2
+//
+// Names left out keep their defaults.
+struct AIWeights {
+    // evaluatePosition, per cell
+    int enemy_distance;   // away from the enemy
+    int center_distance;  // towards the center
+    int landing;          // a bullet lands there, times the turns to spare
+    int edge;             // inside safe_border of the current map
+    int future_edge;      // inside safe_border of the map future_turns on
+    // moveAwayFromDanger
+    int escape_landing;   // per turn a bullet lands there
+    int escape_border;    // per cell from each border point in reach
+    int escape_center;    // per cell from the center
+    // findDodgeMove
+    int dodge_clear;      // no bullet lands there in two turns
+    int dodge_hit;        // per turn one does
+    int dodge_center;     // per cell from the center
+    int dodge_edge;       // inside safe_border
+    // what counts as near the edge, and how far ahead the map shrinks
+    int safe_border;      // cells
+    int future_turns;     // turns, up to DangerMap::TURNS
+
+    AIWeights();
+    bool operator==(const AIWeights& other) const;
+    bool operator!=(const AIWeights& other) const { return !(*this == other); }
+};
+
+// every weight by name, with the range a tuner may move it in
+struct AIWeightInfo {
+    const char* name;
+    int AIWeights::*field;
+    int min_value;
+    int max_value;
+};
+
+const int AI_WEIGHT_COUNT = 14;
+extern const AIWeightInfo AI_WEIGHT_INFO[AI_WEIGHT_COUNT];
+
+// false with error set to "file:line: message", and weights untouched
+bool loadAIWeights(const std::string& filename, AIWeights& weights, std::string& error);
+// every weight, after the comment lines in header
+bool saveAIWeights(const std::string& filename, const AIWeights& weights, const std::string& header);
+
+#endif // AI_WEIGHTS_H
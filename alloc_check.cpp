@@ -0,0 +1,76 @@
+// alloc_check.cpp
+//
+// Build variant (make alloc-check) that replaces the global operator new with a
+// counting one, plays DEMO matches through the normal turn loop with logging
+// and stats on, and fails if any turn after the warm-up allocates.
+
+#include "game_engine.h"
+#include <iostream>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<uint64_t> allocation_count(0);
+
+void* operator new(std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    void* block = std::malloc(size ? size : 1);
+    if (!block) throw std::bad_alloc();
+    return block;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* block) noexcept { std::free(block); }
+void operator delete[](void* block) noexcept { std::free(block); }
+void operator delete(void* block, std::size_t) noexcept { std::free(block); }
+void operator delete[](void* block, std::size_t) noexcept { std::free(block); }
+
+// the first turns size the reusable buffers (frame, log line, AI scratch)
+const int WARMUP_TURNS = 2;
+
+static uint64_t allocations() {
+    return allocation_count.load(std::memory_order_relaxed);
+}
+
+int main() {
+    const int life_points[] = {1, 3, DEFAULT_LIFE_POINTS, 10, 20, 50};
+    std::cout.setstate(std::ios::failbit); // the board would only be noise here
+
+    int games = 0, turns = 0;
+    uint64_t warmup_allocations = 0;
+    for (int life : life_points) {
+        GameEngine engine(DEMO, life, "tankwar-alloc-check.log");
+        engine.setCollectStats(true);
+        engine.setRngSeed(static_cast<uint64_t>(life));
+        if (!engine.initializeGame()) {
+            std::cerr << "alloc-check: cannot start a game with " << life << " life points" << std::endl;
+            return 1;
+        }
+
+        bool running = engine.isGameRunning();
+        while (running) {
+            uint64_t before = allocations();
+            running = engine.gameLoop();
+            uint64_t allocated = allocations() - before;
+
+            int turn = engine.getCurrentTurn();
+            if (turn <= WARMUP_TURNS) {
+                warmup_allocations += allocated;
+            } else if (allocated > 0) {
+                std::cerr << "alloc-check: FAILED, turn " << turn << " of a " << life
+                          << "-life game made " << allocated << " allocations" << std::endl;
+                return 1;
+            }
+            turns++;
+        }
+        engine.endGame();
+        games++;
+    }
+
+    std::cerr << "alloc-check: passed, " << games << " games, " << turns << " turns, no allocation after "
+              << WARMUP_TURNS << " warm-up turns (" << warmup_allocations << " during warm-up)" << std::endl;
+    return 0;
+}
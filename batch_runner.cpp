@@ -0,0 +1,132 @@
+// batch_runner.cpp
+
+#include "batch_runner.h"
+#include "game_engine.h"
+#include "turn_profiler.h"
+#include "endgame_table.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <vector>
+#include <chrono>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+static bool listScripts(const std::string& directory, std::vector<std::string>& paths) {
+#ifndef _WIN32
+    DIR* dir = opendir(directory.c_str());
+    if (!dir) return false;
+
+    while (struct dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] == '.') continue;
+        std::string path = directory + "/" + entry->d_name;
+        struct stat st;
+        if (stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode)) paths.push_back(path);
+    }
+    closedir(dir);
+    std::sort(paths.begin(), paths.end());
+    return true;
+#else
+    (void)directory;
+    (void)paths;
+    return false;
+#endif
+}
+
+static const char* resultName(GameResult result) {
+    switch (result) {
+        case TANK_A_WIN: return "A wins";
+        case TANK_B_WIN: return "B wins";
+        case DRAW:       return "draw";
+        default:         return "unfinished";
+    }
+}
+
+int runScriptBatch(const std::string& directory, const GameConfig& config) {
+    std::vector<std::string> paths;
+    if (!listScripts(directory, paths)) {
+        std::cerr << "Error: Cannot list directory: " << directory << std::endl;
+        return 1;
+    }
+
+    // mapped once for every game
+    std::shared_ptr<EndgameTable> table;
+    if (!config.tablebase_filename.empty()) {
+        table = std::make_shared<EndgameTable>();
+        std::string error;
+        if (!table->open(config.tablebase_filename, error)) {
+            std::cerr << "Error: Cannot read tablebase: " << error << std::endl;
+            return 1;
+        }
+    }
+
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+    int results[4] = {0, 0, 0, 0}; // indexed by GameResult
+    int failed = 0;
+    long long turns = 0;
+    TurnProfiler profile; // all games together
+    DecisionStats decisions[2]; // by tank
+
+    for (const std::string& path : paths) {
+        auto script = std::make_unique<InputScript>();
+        if (!script->open(path)) {
+            std::cerr << "Error: " << script->getError() << std::endl;
+            failed++;
+            continue;
+        }
+
+        GameMode mode = script->hasMode() ? script->getMode() : config.mode;
+        int life = script->hasLifePoints() ? script->getLifePoints() : config.initial_life_points;
+        uint64_t seed = script->hasSeed() ? script->getSeed() : config.rng_seed;
+
+        GameEngine engine(mode, life, "");
+        engine.setHeadless(true);
+        engine.setRngSeed(seed);
+        engine.setPonder(false);
+        engine.setAILevel(config.ai_level);
+        engine.setAIBudget(config.ai_budget);
+        engine.setAIDeadline(config.ai_deadline_ms);
+        engine.setAIWeights(config.ai_weights);
+        engine.setEndgameTable(table);
+        engine.setProfile(config.profile);
+        engine.setInputScript(std::move(script));
+        if (!engine.runGame()) {
+            std::cerr << "Error: " << path << ": cannot start the game" << std::endl;
+            failed++;
+            continue;
+        }
+
+        if (engine.getProfiler()) profile.merge(*engine.getProfiler());
+        for (int i = 0; i < 2; i++) {
+            if (const AIPlayer* ai = engine.getAIPlayer(static_cast<char>('A' + i))) decisions[i].merge(ai->getDecisionStats());
+        }
+        GameResult result = engine.getGameResult();
+        results[result]++;
+        turns += engine.getCurrentTurn();
+        std::cout << path << ": " << resultName(result) << " at turn " << engine.getCurrentTurn() << "\n";
+    }
+
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    int played = static_cast<int>(paths.size()) - failed;
+    std::cout << "=== Batch: " << played << " played, " << failed << " failed"
+              << " | A " << results[TANK_A_WIN] << ", B " << results[TANK_B_WIN]
+              << ", draw " << results[DRAW] << ", unfinished " << results[GAME_CONTINUE]
+              << " | " << turns << " turns in " << std::fixed << std::setprecision(3) << seconds << " s";
+    if (seconds > 0) {
+        std::cout << ", " << std::setprecision(0) << played / seconds << " games/s, "
+                  << turns / seconds << " turns/s";
+    }
+    std::cout << " ===" << std::endl;
+    if (config.profile) std::cout << profile.getSummary() << std::endl;
+    if (config.profile || config.ai_deadline_ms > 0) {
+        for (int i = 0; i < 2; i++) {
+            std::string name = std::string("AI ") + static_cast<char>('A' + i);
+            if (decisions[i].latency.getCount() > 0) std::cout << decisions[i].getSummary(name) << std::endl;
+        }
+    }
+    return failed > 0 ? 1 : 0;
+}
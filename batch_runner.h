@@ -0,0 +1,13 @@
+// batch_runner.h
+
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include <string>
+#include "command_parser.h"
+
+// --batch=<dir>: plays every input script in the directory headless, in name
+// order, one line per script plus totals. returns the process exit code.
+int runScriptBatch(const std::string& directory, const GameConfig& config);
+
+#endif // BATCH_RUNNER_H
@@ -0,0 +1,583 @@
+// benchmark.cpp
+
+#include "benchmark.h"
+#include "game_engine.h"
+#include "mcts_searcher.h"
+#include "minimax_searcher.h"
+#include "worker_pool.h"
+#include "bullet_threats.h"
+#include <iostream>
+#include <thread>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <streambuf>
+#include <algorithm>
+
+typedef std::chrono::steady_clock BenchClock;
+
+static double secondsSince(BenchClock::time_point start) {
+    return std::chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+// a busy full-size board: both tanks and a few dozen bullets in flight
+static void buildRenderScene(GameSnapshot& snapshot) {
+    std::mt19937 rng(1);
+    snapshot.current_turn = 40;
+    snapshot.map_size = INITIAL_MAP_SIZE;
+    snapshot.map_turn_count = 40;
+    snapshot.tank_a.x = 4;
+    snapshot.tank_a.y = 6;
+    snapshot.tank_a.direction = D_Right;
+    snapshot.tank_a.life_points = 7;
+    snapshot.tank_b.x = 15;
+    snapshot.tank_b.y = 12;
+    snapshot.tank_b.direction = D_Up;
+    snapshot.tank_b.life_points = 9;
+
+    snapshot.bullets.resize(60);
+    for (BulletSnapshot& bullet : snapshot.bullets) {
+        bullet.x = static_cast<int>(rng() % (INITIAL_MAP_SIZE + 6)) - 3;
+        bullet.y = static_cast<int>(rng() % (INITIAL_MAP_SIZE + 6)) - 3;
+        bullet.direction = static_cast<Direction>(rng() % 4);
+        bullet.owner_id = (rng() % 2) ? 'A' : 'B';
+        bullet.active = true;
+    }
+}
+
+static int benchRender() {
+    const int frames = 100000;
+
+    GameEngine engine(DEMO, DEFAULT_LIFE_POINTS, "");
+    GameSnapshot scene;
+    buildRenderScene(scene);
+    engine.restoreSnapshot(scene);
+    UIManager& ui = engine.getUIManager();
+
+    ui.printGameMap(engine.getCore()); // warm up buffers
+    BenchClock::time_point start = BenchClock::now();
+    for (int i = 0; i < frames; i++) {
+        ui.printGameMap(engine.getCore());
+    }
+    double elapsed = secondsSince(start);
+
+    std::cerr << "render: " << frames << " frames, " << scene.bullets.size() << " bullets, "
+              << std::fixed << std::setprecision(3) << elapsed << " s, "
+              << std::setprecision(0) << frames / elapsed << " frames/s" << std::endl;
+    return 0;
+}
+
+// swallows std::cout while counting what the game would have sent to the terminal
+class CountingBuffer : public std::streambuf {
+public:
+    uint64_t count;
+    CountingBuffer() : count(0) {}
+protected:
+    int overflow(int c) override { count++; return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { count += n; return n; }
+};
+
+struct DemoOutput {
+    uint64_t bytes;
+    int turns;
+    double seconds;
+    DemoOutput() : bytes(0), turns(0), seconds(0) {}
+};
+
+static void playDemo(uint64_t seed, bool tui, DemoOutput& total) {
+    CountingBuffer counter;
+    std::streambuf* saved = std::cout.rdbuf(&counter);
+
+    BenchClock::time_point start = BenchClock::now();
+    GameEngine engine(DEMO, DEFAULT_LIFE_POINTS, "");
+    engine.setRngSeed(seed);
+    engine.setTui(tui);
+    engine.runGame();
+    total.seconds += secondsSince(start);
+
+    std::cout.rdbuf(saved);
+    total.bytes += counter.count;
+    total.turns += engine.getCurrentTurn();
+}
+
+// terminal traffic of the same seeded DEMO games, full reprint vs in-place redraw
+static int benchTui() {
+    const int games = 50;
+    DemoOutput plain, tui;
+    for (int seed = 1; seed <= games; seed++) {
+        playDemo(seed, false, plain);
+        playDemo(seed, true, tui);
+    }
+
+    const DemoOutput* results[2] = {&plain, &tui};
+    const char* names[2] = {"reprint", "tui"};
+    for (int i = 0; i < 2; i++) {
+        std::cerr << "tui: " << std::setw(7) << names[i] << ": " << games << " games, "
+                  << results[i]->turns << " turns, "
+                  << std::fixed << std::setprecision(0)
+                  << static_cast<double>(results[i]->bytes) / results[i]->turns << " bytes/turn, "
+                  << results[i]->turns / results[i]->seconds << " turns/s" << std::endl;
+    }
+    return 0;
+}
+
+struct MatchScore {
+    int games, wins, draws, losses, turns;
+    double seconds;
+    MatchScore() : games(0), wins(0), draws(0), losses(0), turns(0), seconds(0) {}
+};
+
+// a search level against level 2 from random starts, each start played from both
+// sides; on_game sees the searching player after every match
+template <typename OnGame>
+static void playAgainstBalanced(int level, const SearchBudget& budget, int starts, MatchScore& score, OnGame on_game,
+                                int deadline_ms = 0) {
+    std::mt19937 rng(7);
+    BenchClock::time_point start = BenchClock::now();
+    for (int i = 0; i < starts; i++) {
+        int x_a, y_a, x_b, y_b;
+        do {
+            x_a = rng() % INITIAL_MAP_SIZE; y_a = rng() % INITIAL_MAP_SIZE;
+            x_b = rng() % INITIAL_MAP_SIZE; y_b = rng() % INITIAL_MAP_SIZE;
+        } while (x_a == x_b && y_a == y_b);
+        Direction dir_a = static_cast<Direction>(rng() % 4);
+        Direction dir_b = static_cast<Direction>(rng() % 4);
+
+        for (int side = 0; side < 2; side++) {
+            char search_id = side ? 'B' : 'A';
+            AIPlayer searching(search_id, level, i + 1);
+            AIPlayer balanced(side ? 'A' : 'B', 2, i + 1);
+            searching.setSearchBudget(budget);
+
+            GameCore core;
+            core.placeTanks(x_a, y_a, dir_a, x_b, y_b, dir_b, DEFAULT_LIFE_POINTS);
+            GameResult result = side ? playAIMatch(core, balanced, searching, deadline_ms)
+                                     : playAIMatch(core, searching, balanced, deadline_ms);
+            score.games++;
+            score.turns += core.getCurrentTurn();
+            if (result == DRAW) score.draws++;
+            else if ((result == TANK_A_WIN) == (search_id == 'A')) score.wins++;
+            else score.losses++;
+            on_game(searching);
+        }
+    }
+    score.seconds = secondsSince(start);
+}
+
+static void printScore(const char* bench, const MatchScore& score) {
+    std::cerr << std::fixed << std::setprecision(1)
+              << bench << ": vs level 2: " << score.games << " games, " << score.turns << " turns, +" << score.wins
+              << " =" << score.draws << " -" << score.losses << ", score "
+              << 100.0 * (score.wins + 0.5 * score.draws) / score.games << "%, "
+              << std::setprecision(2) << score.seconds << " s" << std::endl;
+}
+
+static int benchMcts() {
+    SearchBudget budget;
+    uint64_t playouts = 0;
+    double search_seconds = 0;
+    MatchScore score;
+    playAgainstBalanced(4, budget, 20, score, [&](const AIPlayer& player) {
+        playouts += player.getSearcher()->getTotalPlayouts();
+        search_seconds += player.getSearcher()->getTotalSeconds();
+    });
+
+    std::cerr << std::fixed << std::setprecision(0)
+              << "mcts: " << budget.playouts << " playouts/move, " << playouts << " playouts in "
+              << std::setprecision(2) << search_seconds << " s, "
+              << std::setprecision(0) << playouts / search_seconds << " playouts/s" << std::endl;
+    printScore("mcts", score);
+    return 0;
+}
+
+// the same matches at growing depth: speed, how well the ordering prunes, table use
+static int benchMinimax() {
+    for (int depth = 2; depth <= 6; depth += 2) {
+        SearchBudget budget(0, 0, depth);
+        MinimaxSearcher::Stats total;
+        MatchScore score;
+        playAgainstBalanced(5, budget, 20, score, [&](const AIPlayer& player) {
+            const MinimaxSearcher::Stats& stats = player.getMinimax()->getStats();
+            total.nodes += stats.nodes;
+            total.tt_probes += stats.tt_probes;
+            total.tt_hits += stats.tt_hits;
+            total.tt_cutoffs += stats.tt_cutoffs;
+            total.branching_sum += stats.branching_sum;
+            total.branching_count += stats.branching_count;
+            total.seconds += stats.seconds;
+        });
+
+        std::cerr << std::fixed << std::setprecision(0)
+                  << "minimax: depth " << depth << ": " << total.nodes << " nodes in "
+                  << std::setprecision(2) << total.seconds << " s, "
+                  << std::setprecision(0) << total.nodes / total.seconds << " nodes/s, "
+                  << std::setprecision(2) << "branching " << total.branching_sum / std::max<uint64_t>(total.branching_count, 1)
+                  << ", table hits " << std::setprecision(1) << 100.0 * total.tt_hits / std::max<uint64_t>(total.tt_probes, 1)
+                  << "% (" << 100.0 * total.tt_cutoffs / std::max<uint64_t>(total.tt_probes, 1) << "% cutoffs)" << std::endl;
+        printScore("minimax", score);
+    }
+    return 0;
+}
+
+// tanks may leave the map and the board: the planner must refuse those states,
+// not index its tables with them. Long level-1 games are where they turn up.
+static int checkOffMapRoutes() {
+    GameCore core;
+    core.placeTanks(5, 5, D_Right, 10, 10, D_Left, DEFAULT_LIFE_POINTS);
+    AIPlayer player('A', 3, 1);
+    const AIState on_map = player.getGameState(core);
+    const Position off_map[] = {Position(-4, 7), Position(INITIAL_MAP_SIZE + 5, 7), Position(7, -30),
+                                Position(7, INITIAL_MAP_SIZE + 30), Position(1, 8)};
+
+    RoutePlanner planner;
+    int failures = 0;
+    for (const Position& pos : off_map) {
+        Move move = M_Forward;
+        AIState state = on_map;
+        state.current_bounds = MapBounds(3, INITIAL_MAP_SIZE - 4, 3, INITIAL_MAP_SIZE - 4); // (1, 8) is off this one
+        state.my_pos = pos;
+        if (planner.planToFiringLine(state, move) || planner.planToCenter(state, move)) failures++;
+
+        state = on_map;
+        state.enemy_pos = pos;
+        if (pos.x < 0 || pos.x >= INITIAL_MAP_SIZE || pos.y < 0 || pos.y >= INITIAL_MAP_SIZE) {
+            if (planner.planToFiringLine(state, move)) failures++;
+        }
+    }
+
+    const int seeds = 7, life = 100;
+    int turns = 0;
+    for (int seed = 1; seed <= seeds; seed++) {
+        GameEngine engine(DEMO, life, "");
+        engine.setHeadless(true);
+        engine.setRngSeed(seed);
+        engine.setAILevel(1);
+        engine.runGame();
+        turns += engine.getCurrentTurn();
+    }
+    std::cerr << "route: off the map: " << failures << " plans not refused, "
+              << seeds << " level-1 games of " << life << " life, " << turns << " turns" << std::endl;
+    return failures;
+}
+
+// level 3 plans a route to a firing line whenever it is not on one
+static int benchRoute() {
+    int failures = checkOffMapRoutes();
+
+    uint64_t plans = 0, routes = 0, expansions = 0;
+    double plan_seconds = 0;
+    MatchScore score;
+    playAgainstBalanced(3, SearchBudget(), 20, score, [&](const AIPlayer& player) {
+        const RoutePlanner& planner = player.getPlanner();
+        plans += planner.getPlans();
+        routes += planner.getRoutes();
+        expansions += planner.getTotalExpansions();
+        plan_seconds += planner.getTotalSeconds();
+    });
+
+    plans = std::max<uint64_t>(plans, 1);
+    std::cerr << std::fixed << std::setprecision(2)
+              << "route: " << plans << " plans, " << 1e6 * plan_seconds / plans << " us/plan, "
+              << std::setprecision(0) << static_cast<double>(expansions) / plans << " expansions/plan, "
+              << std::setprecision(1) << 100.0 * routes / plans << "% found" << std::endl;
+    printScore("route", score);
+    return failures ? 1 : 0;
+}
+
+// the tasks of one pool run, greedy in order onto the thread free first, as
+// WorkerPool hands them out
+static uint64_t projectMakespan(const uint64_t* task_nodes, int tasks, int threads) {
+    uint64_t busy_until[MAX_SEARCH_THREADS] = {0};
+    for (int t = 0; t < tasks; t++) {
+        uint64_t* first_free = std::min_element(busy_until, busy_until + threads);
+        *first_free += task_nodes[t];
+    }
+    return *std::max_element(busy_until, busy_until + threads);
+}
+
+// level-5 searches of positions from level-2 games, serial and with the root
+// split over 1, 2, 4 and 8 threads; every split search must pick the serial
+// move. The projected speedup is what the last pass's task sizes allow on as
+// many cores as threads, against the serial node count.
+static int benchThreads() {
+    const int starts = 6, every = 5, depth = 7;
+    const int thread_counts[] = {0, 1, 2, 4, 8}; // 0: serial
+
+    std::vector<GameSnapshot> positions;
+    std::mt19937 rng(7);
+    for (int i = 0; i < starts; i++) {
+        AIPlayer ai_a('A', 2, i + 1), ai_b('B', 2, i + 1);
+        GameCore core;
+        core.placeTanks(rng() % INITIAL_MAP_SIZE, rng() % INITIAL_MAP_SIZE, static_cast<Direction>(rng() % 4),
+                        rng() % INITIAL_MAP_SIZE, rng() % INITIAL_MAP_SIZE, static_cast<Direction>(rng() % 4),
+                        DEFAULT_LIFE_POINTS);
+        while (core.getCurrentTurn() < 200) {
+            if (core.getCurrentTurn() % every == 0) {
+                positions.emplace_back();
+                core.captureSnapshot(positions.back());
+            }
+            core.beginTurn();
+            core.applyMove('A', ai_a.makeDecision(core));
+            core.applyMove('B', ai_b.makeDecision(core));
+            if (core.checkTankCollision()) break;
+            core.finishTurn();
+            if (core.checkGameEnd() != GAME_CONTINUE) break;
+        }
+    }
+
+    std::cerr << "threads: " << positions.size() << " positions, depth " << depth << ", "
+              << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+    std::vector<Move> serial_moves;
+    uint64_t serial_nodes = 0;
+    double serial_seconds = 0, one_thread_seconds = 0;
+    int mismatches = 0;
+    const int hint[3] = {0, 0, 0}; // the natural order for the first pass
+    for (int threads : thread_counts) {
+        MinimaxSearcher searcher;
+        std::unique_ptr<WorkerPool> pool;
+        if (threads > 0) pool.reset(new WorkerPool(threads));
+        uint64_t last_pass = 0, makespan = 0;
+        int differing = 0;
+
+        for (size_t i = 0; i < positions.size(); i++) {
+            GameCore core;
+            core.restoreSnapshot(positions[i]);
+            core.beginTurn();
+            Move move = searcher.search(core, 'A', SearchBudget(0, 0, depth), hint, pool.get());
+            if (threads == 0) {
+                serial_moves.push_back(move);
+                continue;
+            }
+            if (move != serial_moves[i]) differing++;
+
+            const MinimaxSearcher::PassProfile& pass = searcher.getLastPass();
+            for (int run = 0; run < pass.runs; run++) {
+                makespan += projectMakespan(pass.nodes[run], pass.tasks[run], threads);
+                for (int t = 0; t < pass.tasks[run]; t++) last_pass += pass.nodes[run][t];
+            }
+        }
+        mismatches += differing;
+
+        const MinimaxSearcher::Stats& stats = searcher.getStats();
+        double ms = 1000.0 * stats.seconds / positions.size();
+        std::cerr << std::fixed << std::setprecision(2) << "threads: ";
+        if (threads == 0) {
+            serial_seconds = stats.seconds;
+            serial_nodes = stats.nodes;
+            std::cerr << "serial: " << stats.nodes << " nodes, " << ms << " ms/search" << std::endl;
+            continue;
+        }
+        if (threads == 1) one_thread_seconds = stats.seconds;
+        // the split costs extra nodes: scale the ideal by how many more it searches
+        double projected = static_cast<double>(last_pass) / std::max<uint64_t>(makespan, 1) *
+                           serial_nodes / std::max<uint64_t>(stats.nodes, 1);
+        std::cerr << threads << ": " << stats.nodes << " nodes, " << ms << " ms/search, speedup "
+                  << serial_seconds / stats.seconds << "x on serial, "
+                  << one_thread_seconds / stats.seconds << "x on 1 thread, projected "
+                  << projected << "x on serial, " << differing << " moves differ" << std::endl;
+    }
+    return mismatches ? 1 : 0;
+}
+
+// random boards for the bullet term of the level-5 evaluation, a third of the
+// bullets lined up on a tank so that there is something to count
+static void buildThreatStates(std::vector<SimState>& states) {
+    std::mt19937 rng(11);
+    const int DX[4] = {-1, 0, 1, 0}, DY[4] = {0, -1, 0, 1};
+    for (SimState& state : states) {
+        for (SimTank& tank : state.tanks) {
+            tank.x = rng() % INITIAL_MAP_SIZE;
+            tank.y = rng() % INITIAL_MAP_SIZE;
+        }
+        state.bullet_count = rng() % (MAX_LIVE_BULLETS + 1);
+        for (int i = 0; i < state.bullet_count; i++) {
+            SimBullet& bullet = state.bullets[i];
+            int dir = rng() % 4;
+            bullet.direction = static_cast<uint8_t>(dir);
+            bullet.owner_id = (rng() % 2) ? 'A' : 'B';
+            if (rng() % 3 == 0) {
+                const SimTank& target = state.tanks[rng() % 2];
+                int back = 1 + rng() % 5; // 1 to 5 cells behind it: some land on it, some do not
+                bullet.x = static_cast<int16_t>(target.x - DX[dir] * back);
+                bullet.y = static_cast<int16_t>(target.y - DY[dir] * back);
+            } else {
+                int area = BULLET_AREA + BULLET_OUT_OF_BOUNDS_OFFSET;
+                bullet.x = static_cast<int16_t>(static_cast<int>(rng() % (2 * area)) - area);
+                bullet.y = static_cast<int16_t>(static_cast<int>(rng() % (2 * area)) - area);
+            }
+        }
+    }
+}
+
+// the per-bullet loop MinimaxSearcher::evaluate ran before the kernels, kept
+// word for word as the reference they are held to
+static void countThreatsInline(const SimState& state, int threats[2]) {
+    const int DX[4] = {-1, 0, 1, 0}, DY[4] = {0, -1, 0, 1};
+    for (int t = 0; t < 2; t++) {
+        const SimTank& tank = state.tanks[t];
+        threats[t] = 0;
+        char enemy_id = static_cast<char>('A' + (1 - t));
+        for (int i = 0; i < state.bullet_count; i++) {
+            const SimBullet& bullet = state.bullets[i];
+            if (bullet.owner_id != enemy_id) continue;
+            int bx = tank.x - bullet.x, by = tank.y - bullet.y;
+            int along = (by == 0) ? bx * DX[bullet.direction] : (bx == 0) ? by * DY[bullet.direction] : 0;
+            if (along > 0 && along <= 2 * BULLET_SPEED && along % BULLET_SPEED == 0) threats[t]++;
+        }
+    }
+}
+
+// every kernel the CPU has, the scalar one included, against the loop the
+// evaluation used to run itself: the counts must agree on every board. Few
+// enough boards to stay in cache, as the leaves of one search do.
+static int benchEval() {
+    const int boards = 512, rounds = 1600;
+    std::vector<SimState> states(boards);
+    buildThreatStates(states);
+
+    uint64_t bullets = 0, threats = 0;
+    for (const SimState& state : states) bullets += state.bullet_count;
+
+    const ThreatKernel kernels[] = {THREAT_KERNEL_SCALAR, THREAT_KERNEL_AVX2};
+    double scalar_ns = 0;
+    int mismatches = 0;
+    std::cerr << "eval: " << boards << " boards, " << std::fixed << std::setprecision(1)
+              << static_cast<double>(bullets) / boards << " bullets avg, in use: "
+              << getThreatKernelName(getThreatKernel()) << std::endl;
+    for (ThreatKernel kernel : kernels) {
+        if (!isThreatKernelSupported(kernel)) {
+            std::cerr << "eval: " << getThreatKernelName(kernel) << ": not supported here" << std::endl;
+            continue;
+        }
+        int differing = 0;
+        for (const SimState& state : states) {
+            int expected[2], counted[2];
+            countThreatsInline(state, expected);
+            countBulletThreats(kernel, state, counted);
+            if (expected[0] != counted[0] || expected[1] != counted[1]) differing++;
+            if (kernel == THREAT_KERNEL_SCALAR) threats += expected[0] + expected[1];
+        }
+        mismatches += differing;
+
+        uint64_t timed_threats = 0;
+        BenchClock::time_point start = BenchClock::now();
+        for (int r = 0; r < rounds; r++) {
+            for (const SimState& state : states) {
+                int counted[2];
+                countBulletThreats(kernel, state, counted);
+                timed_threats += counted[0] + counted[1];
+            }
+        }
+        double ns = 1e9 * secondsSince(start) / (static_cast<double>(rounds) * boards);
+        if (kernel == THREAT_KERNEL_SCALAR) scalar_ns = ns;
+        if (timed_threats != threats * rounds) differing = boards; // counted differently when timed
+        std::cerr << "eval: " << std::setw(6) << getThreatKernelName(kernel) << ": " << std::setprecision(1)
+                  << ns << " ns/board, " << std::setprecision(2) << scalar_ns / ns << "x, "
+                  << differing << " boards differ" << std::endl;
+        mismatches += differing;
+    }
+    std::cerr << "eval: " << threats << " threats counted" << std::endl;
+    return mismatches ? 1 : 0;
+}
+
+// level-2 decisions with the board as full of bullets as the rules allow, the
+// state read from the engine and the decision on it timed apart
+static int benchAi() {
+    const int positions = 2000, turns = 8;
+    std::mt19937 rng(3);
+    uint64_t decisions = 0, bullets = 0;
+    double read_seconds = 0, decide_seconds = 0;
+
+    for (int p = 0; p < positions; p++) {
+        GameSnapshot snapshot;
+        snapshot.current_turn = 1;
+        snapshot.map_turn_count = 1;
+        TankSnapshot* tanks[2] = {&snapshot.tank_a, &snapshot.tank_b};
+        for (TankSnapshot* tank : tanks) {
+            tank->x = 2 + rng() % (INITIAL_MAP_SIZE - 4);
+            tank->y = 2 + rng() % (INITIAL_MAP_SIZE - 4);
+            tank->direction = static_cast<Direction>(rng() % 4);
+            tank->life_points = DEFAULT_LIFE_POINTS;
+        }
+        snapshot.bullets.resize(MAX_LIVE_BULLETS - 2 * turns); // room for the shots of every turn
+        for (BulletSnapshot& bullet : snapshot.bullets) {
+            bullet.x = rng() % INITIAL_MAP_SIZE;
+            bullet.y = rng() % INITIAL_MAP_SIZE;
+            bullet.direction = static_cast<Direction>(rng() % 4);
+            bullet.owner_id = (rng() % 2) ? 'A' : 'B';
+        }
+        GameCore core;
+        core.placeTanks(0, 0, D_Up, 1, 1, D_Up, DEFAULT_LIFE_POINTS);
+        core.restoreSnapshot(snapshot);
+
+        AIPlayer players[2] = {AIPlayer('A', 2, p + 1), AIPlayer('B', 2, p + 1)};
+        AIState states[2];
+        for (int t = 0; t < turns; t++) {
+            core.beginTurn();
+            for (int i = 0; i < 2; i++) {
+                BenchClock::time_point start = BenchClock::now();
+                players[i].getGameState(core, states[i]);
+                BenchClock::time_point middle = BenchClock::now();
+                Move move = players[i].makeDecision(states[i]);
+                BenchClock::time_point end = BenchClock::now();
+
+                read_seconds += std::chrono::duration<double>(middle - start).count();
+                decide_seconds += std::chrono::duration<double>(end - middle).count();
+                decisions++;
+                bullets += states[i].bullets.size();
+                core.applyMove(i ? 'B' : 'A', move);
+            }
+            if (core.checkTankCollision()) break;
+            core.finishTurn();
+            if (core.checkGameEnd() != GAME_CONTINUE) break;
+        }
+    }
+
+    double seconds = read_seconds + decide_seconds;
+    std::cerr << std::fixed << std::setprecision(0)
+              << "ai: " << decisions << " decisions, "
+              << static_cast<double>(bullets) / decisions << " bullets avg, "
+              << decisions / seconds << " decisions/s" << std::endl;
+    std::cerr << "ai: read state " << 1e9 * read_seconds / decisions << " ns, decide "
+              << 1e9 * decide_seconds / decisions << " ns per decision" << std::endl;
+    return 0;
+}
+
+// both search levels with nothing but a deadline to stop them, searching as
+// deep as it allows; fails if the 99th percentile decision misses it, counted
+// exactly rather than read off the histogram, whose buckets are 12.5% wide
+static int benchDeadline() {
+    const int deadline_ms = 20; // a frame at 50 fps
+    const int levels[] = {4, 5};
+    const SearchBudget budgets[] = {SearchBudget(0, 0), SearchBudget(0, 0, MAX_SEARCH_DEPTH)};
+    int failed = 0;
+    for (int i = 0; i < 2; i++) {
+        DecisionStats stats;
+        MatchScore score;
+        playAgainstBalanced(levels[i], budgets[i], 6, score, [&](const AIPlayer& player) {
+            stats.merge(player.getDecisionStats());
+        }, deadline_ms);
+
+        bool met = stats.deadline_misses * 100 <= stats.deadline_decisions;
+        if (!met) failed++;
+        std::cerr << "deadline: level " << levels[i] << ", " << deadline_ms << " ms: "
+                  << stats.getSummary("decisions") << (met ? ", p99 met" : ", p99 MISSED") << std::endl;
+        printScore("deadline", score);
+    }
+    return failed ? 1 : 0;
+}
+
+int runBenchmark(const std::string& name) {
+    if (name == "render") return benchRender();
+    if (name == "tui") return benchTui();
+    if (name == "mcts") return benchMcts();
+    if (name == "minimax") return benchMinimax();
+    if (name == "route") return benchRoute();
+    if (name == "ai") return benchAi();
+    if (name == "threads") return benchThreads();
+    if (name == "eval") return benchEval();
+    if (name == "deadline") return benchDeadline();
+
+    std::cerr << "Unknown benchmark: " << name << " (available: render, tui, mcts, minimax, route, ai, threads, eval, deadline)" << std::endl;
+    return 1;
+}
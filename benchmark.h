@@ -0,0 +1,12 @@
+// benchmark.h
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+
+// micro benchmarks selected with --bench=<name>; results go to stderr so that
+// frame output can be sent to /dev/null. returns the process exit code.
+int runBenchmark(const std::string& name);
+
+#endif // BENCHMARK_H
@@ -0,0 +1,44 @@
+// binary_io.h
+
+#ifndef BINARY_IO_H
+#define BINARY_IO_H
+
+#include <vector>
+#include <cstdint>
+
+// little-endian helpers for the replay and checkpoint file formats
+
+inline void appendU8(std::vector<uint8_t>& out, uint8_t value) {
+    out.push_back(value);
+}
+
+inline void appendU16(std::vector<uint8_t>& out, uint16_t value) {
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+inline void appendU32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+}
+
+inline void appendU64(std::vector<uint8_t>& out, uint64_t value) {
+    for (int i = 0; i < 8; i++) out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+}
+
+inline uint16_t readU16(const uint8_t* in) {
+    return static_cast<uint16_t>(in[0] | (in[1] << 8));
+}
+
+inline uint32_t readU32(const uint8_t* in) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) value |= static_cast<uint32_t>(in[i]) << (i * 8);
+    return value;
+}
+
+inline uint64_t readU64(const uint8_t* in) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) value |= static_cast<uint64_t>(in[i]) << (i * 8);
+    return value;
+}
+
+#endif // BINARY_IO_H
@@ -0,0 +1,149 @@
+// bullet_threats.cpp
+
+#include "bullet_threats.h"
+#include <cstddef>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_AVX2_KERNEL 1
+#include <immintrin.h>
+#endif
+
+static const int DX[4] = {-1, 0, 1, 0}; // by Direction: left, up, right, down
+static const int DY[4] = {0, -1, 0, 1};
+
+// a bullet lands on BULLET_SPEED and 2 * BULLET_SPEED cells ahead in the next
+// two turns; anything else in its line it flies over
+static void countScalar(const SimState& state, int threats[2]) {
+    for (int t = 0; t < 2; t++) {
+        const SimTank& tank = state.tanks[t];
+        char enemy_id = static_cast<char>('A' + (1 - t));
+        int count = 0;
+        for (int i = 0; i < state.bullet_count; i++) {
+            const SimBullet& bullet = state.bullets[i];
+            if (bullet.owner_id != enemy_id) continue;
+            int bx = tank.x - bullet.x, by = tank.y - bullet.y;
+            int along = (by == 0) ? bx * DX[bullet.direction] : (bx == 0) ? by * DY[bullet.direction] : 0;
+            if (along > 0 && along <= 2 * BULLET_SPEED && along % BULLET_SPEED == 0) count++;
+        }
+        threats[t] = count;
+    }
+}
+
+#ifdef HAVE_AVX2_KERNEL
+// x in the low and y in the high half, as a SimBullet stores them
+static inline int packCell(int x, int y) {
+    return static_cast<int>(static_cast<uint16_t>(x) | static_cast<uint32_t>(static_cast<uint16_t>(y)) << 16);
+}
+
+// Four bullets, 24 bytes, as two 16-byte halves that overlap by 8: bullets 0
+// and 1 sit at bytes 0 and 6 of the low one, 2 and 3 at bytes 4 and 10 of the
+// high one. Each lane comes out as x|y of its two bullets, then their
+// direction|owner.
+__attribute__((target("avx2")))
+static inline __m256i loadFour(const SimBullet* bullets) {
+    const __m256i order = _mm256_setr_epi8(0, 1, 2, 3, 6, 7, 8, 9, 4, 5, -1, -1, 10, 11, -1, -1,
+                                           4, 5, 6, 7, 10, 11, 12, 13, 8, 9, -1, -1, 14, 15, -1, -1);
+    const char* bytes = reinterpret_cast<const char*>(bullets);
+    __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+    __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + 8));
+    return _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1), order);
+}
+
+// The same test turned around: the tank sits on bullet + k * step, k = 1 or 2,
+// with step one turn of flight. Cells are compared packed, 16 bits a coordinate.
+__attribute__((target("avx2")))
+static void countAvx2(const SimState& state, int threats[2]) {
+    static_assert(sizeof(SimBullet) == 6 && offsetof(SimBullet, direction) == 4 && offsetof(SimBullet, owner_id) == 5,
+                  "loadFour takes bullets apart by their byte layout");
+
+    const __m256i steps = _mm256_setr_epi32(packCell(DX[0] * BULLET_SPEED, DY[0] * BULLET_SPEED),
+                                            packCell(DX[1] * BULLET_SPEED, DY[1] * BULLET_SPEED),
+                                            packCell(DX[2] * BULLET_SPEED, DY[2] * BULLET_SPEED),
+                                            packCell(DX[3] * BULLET_SPEED, DY[3] * BULLET_SPEED), 0, 0, 0, 0);
+    const __m256i cell_a = _mm256_set1_epi32(packCell(state.tanks[0].x, state.tanks[0].y));
+    const __m256i cell_b = _mm256_set1_epi32(packCell(state.tanks[1].x, state.tanks[1].y));
+    const __m256i owner_a = _mm256_set1_epi32('A');
+    const __m256i owner_b = _mm256_set1_epi32('B');
+    const __m256i byte_mask = _mm256_set1_epi32(0xFF);
+
+    int on_a = 0, on_b = 0;
+    int i = 0;
+    for (; i + 8 <= state.bullet_count; i += 8) {
+        __m256i first_four = loadFour(state.bullets + i);
+        __m256i last_four = loadFour(state.bullets + i + 4);
+        __m256i cell = _mm256_unpacklo_epi64(first_four, last_four);
+        __m256i rest = _mm256_unpackhi_epi64(first_four, last_four);
+        __m256i direction = _mm256_and_si256(rest, byte_mask);
+        __m256i owner = _mm256_srli_epi32(rest, 8);
+
+        __m256i step = _mm256_permutevar8x32_epi32(steps, direction);
+        __m256i first = _mm256_add_epi16(cell, step);
+        __m256i second = _mm256_add_epi16(first, step);
+
+        __m256i from_a = _mm256_cmpeq_epi32(owner, owner_a);
+        __m256i from_b = _mm256_cmpeq_epi32(owner, owner_b);
+        __m256i target = _mm256_blendv_epi8(cell_a, cell_b, from_a); // A's bullets threaten B
+        __m256i hit = _mm256_or_si256(_mm256_cmpeq_epi32(first, target), _mm256_cmpeq_epi32(second, target));
+
+        int hits = _mm256_movemask_ps(_mm256_castsi256_ps(hit));
+        on_b += __builtin_popcount(hits & _mm256_movemask_ps(_mm256_castsi256_ps(from_a)));
+        on_a += __builtin_popcount(hits & _mm256_movemask_ps(_mm256_castsi256_ps(from_b)));
+    }
+
+    // the last few one by one
+    for (; i < state.bullet_count; i++) {
+        const SimBullet& bullet = state.bullets[i];
+        int t = (bullet.owner_id == 'A') ? 1 : (bullet.owner_id == 'B') ? 0 : -1;
+        if (t < 0) continue;
+        int step_x = DX[bullet.direction] * BULLET_SPEED, step_y = DY[bullet.direction] * BULLET_SPEED;
+        int x = state.tanks[t].x, y = state.tanks[t].y;
+        if ((x == bullet.x + step_x && y == bullet.y + step_y) ||
+            (x == bullet.x + 2 * step_x && y == bullet.y + 2 * step_y)) {
+            if (t == 0) on_a++;
+            else on_b++;
+        }
+    }
+    threats[0] = on_a;
+    threats[1] = on_b;
+}
+#endif
+
+static ThreatKernel pickKernel() {
+    return isThreatKernelSupported(THREAT_KERNEL_AVX2) ? THREAT_KERNEL_AVX2 : THREAT_KERNEL_SCALAR;
+}
+
+static const ThreatKernel active_kernel = pickKernel();
+
+void countBulletThreats(const SimState& state, int threats[2]) {
+    countBulletThreats(active_kernel, state, threats);
+}
+
+void countBulletThreats(ThreatKernel kernel, const SimState& state, int threats[2]) {
+#ifdef HAVE_AVX2_KERNEL
+    if (kernel == THREAT_KERNEL_AVX2) {
+        countAvx2(state, threats);
+        return;
+    }
+#else
+    (void)kernel;
+#endif
+    countScalar(state, threats);
+}
+
+ThreatKernel getThreatKernel() {
+    return active_kernel;
+}
+
+bool isThreatKernelSupported(ThreatKernel kernel) {
+    if (kernel == THREAT_KERNEL_SCALAR) return true;
+#ifdef HAVE_AVX2_KERNEL
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+const char* getThreatKernelName(ThreatKernel kernel) {
+    return (kernel == THREAT_KERNEL_AVX2) ? "avx2" : "scalar";
+}
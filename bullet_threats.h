@@ -0,0 +1,27 @@
+// bullet_threats.h
+
+#ifndef BULLET_THREATS_H
+#define BULLET_THREATS_H
+
+#include "sim_state.h"
+
+// The bullet term of the level-5 evaluation: for each tank, the enemy bullets
+// that land on its cell in one of the next two turns if it stays. Every leaf
+// of the search needs it, against every bullet on the board, so there is an
+// AVX2 kernel that takes eight bullets at a time and compares them with both
+// tanks at once. It is picked at run time when the CPU has AVX2; otherwise,
+// and off x86, the scalar loop runs. Both count exactly the same.
+enum ThreatKernel {
+    THREAT_KERNEL_SCALAR,
+    THREAT_KERNEL_AVX2
+};
+
+// threats[0]: B's bullets landing on A, threats[1]: A's bullets landing on B
+void countBulletThreats(const SimState& state, int threats[2]);
+void countBulletThreats(ThreatKernel kernel, const SimState& state, int threats[2]);
+
+ThreatKernel getThreatKernel();              // the one countBulletThreats uses
+bool isThreatKernelSupported(ThreatKernel kernel);
+const char* getThreatKernelName(ThreatKernel kernel);
+
+#endif // BULLET_THREATS_H
@@ -0,0 +1,180 @@
+// checkpoint.cpp
+
+#include "checkpoint.h"
+#include "binary_io.h"
+#include <fstream>
+#include <iterator>
+#include <cstdio>
+#include <csignal>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static const char CHECKPOINT_MAGIC[4] = {'T', 'W', 'C', 'K'};
+
+// state shared with the SIGTERM handler; one checkpoint file per process
+static std::vector<uint8_t> staged_buffers[2];
+static volatile sig_atomic_t staged_index = -1;
+static std::string signal_filename;
+static std::string signal_temp_filename;
+
+// only uses async-signal-safe calls so the signal handler can share it
+static bool writeFileAtomically(const char* path, const char* temp_path,
+                                const uint8_t* data, size_t size) {
+#ifndef _WIN32
+    int fd = ::open(temp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+
+    size_t written = 0;
+    while (written < size) {
+        ssize_t n = ::write(fd, data + written, size - written);
+        if (n <= 0) {
+            ::close(fd);
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    if (::fsync(fd) != 0) {
+        ::close(fd);
+        return false;
+    }
+    ::close(fd);
+    return ::rename(temp_path, path) == 0;
+#else
+    std::ofstream file(temp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+    file.write(reinterpret_cast<const char*>(data), size);
+    file.close();
+    if (!file) return false;
+    std::remove(path);
+    return std::rename(temp_path, path) == 0;
+#endif
+}
+
+#ifndef _WIN32
+static void handleTerminateSignal(int signal_number) {
+    int index = staged_index;
+    if (index >= 0) {
+        const std::vector<uint8_t>& buffer = staged_buffers[index];
+        writeFileAtomically(signal_filename.c_str(), signal_temp_filename.c_str(),
+                            buffer.data(), buffer.size());
+    }
+    _exit(128 + signal_number);
+}
+#endif
+
+CheckpointManager::CheckpointManager(const std::string& file_name, int interval)
+    : filename(file_name), temp_filename(file_name + ".tmp"), interval_turns(interval) {
+}
+
+CheckpointManager::~CheckpointManager() {}
+
+bool CheckpointManager::isDue(int turn) const {
+    return interval_turns > 0 && turn > 0 && turn % interval_turns == 0;
+}
+
+bool CheckpointManager::write(const MatchCheckpoint& checkpoint) {
+    encode_buffer.clear();
+    encode(checkpoint, encode_buffer);
+    return writeFileAtomically(filename.c_str(), temp_filename.c_str(),
+                               encode_buffer.data(), encode_buffer.size());
+}
+
+void CheckpointManager::stage(const MatchCheckpoint& checkpoint) {
+    // fill the buffer the handler is not looking at, then switch over
+    int next = (staged_index == 0) ? 1 : 0;
+    staged_buffers[next].clear();
+    encode(checkpoint, staged_buffers[next]);
+    staged_index = next;
+}
+
+void CheckpointManager::installSignalHandler() {
+#ifndef _WIN32
+    signal_filename = filename;
+    signal_temp_filename = temp_filename;
+
+    struct sigaction action;
+    action.sa_handler = handleTerminateSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = 0;
+    sigaction(SIGTERM, &action, nullptr);
+#endif
+}
+
+bool CheckpointManager::load(const std::string& file_name, MatchCheckpoint& checkpoint) {
+    std::ifstream file(file_name, std::ios::in | std::ios::binary);
+    if (!file.is_open()) return false;
+
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)),
+                              std::istreambuf_iterator<char>());
+    return decode(data.data(), data.size(), checkpoint);
+}
+
+static void encodeAI(const AICheckpoint& ai, std::vector<uint8_t>& out) {
+    appendU8(out, ai.present ? 1 : 0);
+    if (!ai.present) return;
+
+    appendU8(out, static_cast<uint8_t>(ai.difficulty_level));
+    appendU8(out, static_cast<uint8_t>(ai.edge_linger_turns));
+    appendU64(out, ai.random_draws);
+    appendU8(out, static_cast<uint8_t>(ai.move_history.size()));
+    for (Move move : ai.move_history) appendU8(out, static_cast<uint8_t>(move));
+}
+
+static size_t decodeAI(const uint8_t* data, size_t size, AICheckpoint& ai) {
+    if (size < 1) return 0;
+    ai.present = data[0] != 0;
+    if (!ai.present) return 1;
+
+    if (size < 12) return 0;
+    ai.difficulty_level = data[1];
+    ai.edge_linger_turns = data[2];
+    ai.random_draws = readU64(data + 3);
+    size_t history_size = data[11];
+    if (size < 12 + history_size) return 0;
+
+    ai.move_history.clear();
+    for (size_t i = 0; i < history_size; i++) {
+        if (data[12 + i] > M_Right) return 0;
+        ai.move_history.push_back(static_cast<Move>(data[12 + i]));
+    }
+    return 12 + history_size;
+}
+
+void CheckpointManager::encode(const MatchCheckpoint& checkpoint, std::vector<uint8_t>& out) {
+    for (int i = 0; i < 4; i++) appendU8(out, static_cast<uint8_t>(CHECKPOINT_MAGIC[i]));
+    appendU8(out, static_cast<uint8_t>(CHECKPOINT_VERSION));
+    appendU8(out, static_cast<uint8_t>(checkpoint.mode));
+    appendU8(out, static_cast<uint8_t>(checkpoint.initial_life_points));
+    appendU8(out, 0);
+    appendU64(out, checkpoint.rng_seed);
+    encodeSnapshot(checkpoint.snapshot, out);
+    encodeAI(checkpoint.ai_a, out);
+    encodeAI(checkpoint.ai_b, out);
+}
+
+bool CheckpointManager::decode(const uint8_t* data, size_t size, MatchCheckpoint& checkpoint) {
+    if (size < 16) return false;
+    for (int i = 0; i < 4; i++) {
+        if (data[i] != static_cast<uint8_t>(CHECKPOINT_MAGIC[i])) return false;
+    }
+    if (data[4] != CHECKPOINT_VERSION || data[5] > DEMO) return false;
+
+    checkpoint.mode = static_cast<GameMode>(data[5]);
+    checkpoint.initial_life_points = data[6];
+    checkpoint.rng_seed = readU64(data + 8);
+
+    size_t offset = 16;
+    size_t used = decodeSnapshot(data + offset, size - offset, checkpoint.snapshot);
+    if (used == 0) return false;
+    offset += used;
+
+    used = decodeAI(data + offset, size - offset, checkpoint.ai_a);
+    if (used == 0) return false;
+    offset += used;
+
+    used = decodeAI(data + offset, size - offset, checkpoint.ai_b);
+    return used != 0;
+}
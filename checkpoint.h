@@ -0,0 +1,68 @@
+// checkpoint.h
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "common.h"
+#include "game_snapshot.h"
+
+// Checkpoint file layout (little-endian):
+//   "TWCK", version, mode, initial life, rng seed
+//   GameSnapshot (see game_snapshot.h)
+//   per AI player (A, B): present flag, difficulty, edge linger turns,
+//                         random draws, move history
+// Files are written to "<file>.tmp" and renamed over the previous checkpoint.
+
+const int CHECKPOINT_VERSION = 1;
+
+struct AICheckpoint {
+    bool present;
+    int difficulty_level;
+    int edge_linger_turns;
+    uint64_t random_draws;
+    std::vector<Move> move_history;
+
+    AICheckpoint() : present(false), difficulty_level(2), edge_linger_turns(0), random_draws(0) {}
+};
+
+struct MatchCheckpoint {
+    GameMode mode;
+    int initial_life_points;
+    uint64_t rng_seed;
+    GameSnapshot snapshot;
+    AICheckpoint ai_a;
+    AICheckpoint ai_b;
+
+    MatchCheckpoint() : mode(PVP), initial_life_points(DEFAULT_LIFE_POINTS), rng_seed(0) {}
+};
+
+class CheckpointManager {
+private:
+    std::string filename;
+    std::string temp_filename;
+    int interval_turns; // <= 0: only on SIGTERM
+    std::vector<uint8_t> encode_buffer;
+
+public:
+    CheckpointManager(const std::string& file_name, int interval);
+    ~CheckpointManager();
+
+    bool isDue(int turn) const;
+    bool write(const MatchCheckpoint& checkpoint);
+
+    // keep an encoded copy that the SIGTERM handler can write without allocating
+    void stage(const MatchCheckpoint& checkpoint);
+    void installSignalHandler();
+
+    std::string getFilename() const { return filename; }
+    int getIntervalTurns() const { return interval_turns; }
+
+    static bool load(const std::string& file_name, MatchCheckpoint& checkpoint);
+    static void encode(const MatchCheckpoint& checkpoint, std::vector<uint8_t>& out);
+    static bool decode(const uint8_t* data, size_t size, MatchCheckpoint& checkpoint);
+};
+
+#endif // CHECKPOINT_H
@@ -1,9 +1,43 @@
 // command_parser.cpp
 
 #include "command_parser.h"
+#include "shared_state.h"
+#include "ai_player.h"
 #include <iostream>
 #include <getopt.h>
 #include <cstring>
+#include <cstdlib>
+
+// long-only options
+enum {
+    OPT_RECORD = 256,
+    OPT_REPLAY,
+    OPT_REPLAY_PACE,
+    OPT_SEEK,
+    OPT_CHECKPOINT,
+    OPT_CHECKPOINT_EVERY,
+    OPT_RESUME,
+    OPT_STATS,
+    OPT_SPECTATE,
+    OPT_SEED,
+    OPT_BENCH,
+    OPT_TUI,
+    OPT_FPS,
+    OPT_RAW_INPUT,
+    OPT_MOVE_TIMEOUT,
+    OPT_NO_PONDER,
+    OPT_SHM,
+    OPT_INPUT_SCRIPT,
+    OPT_BATCH,
+    OPT_PROFILE,
+    OPT_AI_LEVEL,
+    OPT_AI_BUDGET,
+    OPT_AI_DEPTH,
+    OPT_AI_THREADS,
+    OPT_AI_DEADLINE,
+    OPT_AI_WEIGHTS,
+    OPT_TABLEBASE
+};
 
 CommandParser::CommandParser() {
     setDefaultConfig();
@@ -19,6 +53,33 @@ bool CommandParser::parseArguments(int argc, char* argv[]) {
         {"log-file", required_argument, 0, 'l'},
         {"mode", required_argument, 0, 'm'},
         {"initial-life", required_argument, 0, 'p'},
+        {"record", required_argument, 0, OPT_RECORD},
+        {"replay", required_argument, 0, OPT_REPLAY},
+        {"replay-pace", required_argument, 0, OPT_REPLAY_PACE},
+        {"seek", required_argument, 0, OPT_SEEK},
+        {"checkpoint", required_argument, 0, OPT_CHECKPOINT},
+        {"checkpoint-every", required_argument, 0, OPT_CHECKPOINT_EVERY},
+        {"resume", required_argument, 0, OPT_RESUME},
+        {"stats", no_argument, 0, OPT_STATS},
+        {"spectate", required_argument, 0, OPT_SPECTATE},
+        {"seed", required_argument, 0, OPT_SEED},
+        {"bench", required_argument, 0, OPT_BENCH},
+        {"tui", no_argument, 0, OPT_TUI},
+        {"fps", required_argument, 0, OPT_FPS},
+        {"raw-input", no_argument, 0, OPT_RAW_INPUT},
+        {"move-timeout", required_argument, 0, OPT_MOVE_TIMEOUT},
+        {"no-ponder", no_argument, 0, OPT_NO_PONDER},
+        {"shm", optional_argument, 0, OPT_SHM},
+        {"input-script", required_argument, 0, OPT_INPUT_SCRIPT},
+        {"batch", required_argument, 0, OPT_BATCH},
+        {"profile", no_argument, 0, OPT_PROFILE},
+        {"ai-level", required_argument, 0, OPT_AI_LEVEL},
+        {"ai-budget", required_argument, 0, OPT_AI_BUDGET},
+        {"ai-depth", required_argument, 0, OPT_AI_DEPTH},
+        {"ai-threads", required_argument, 0, OPT_AI_THREADS},
+        {"ai-deadline", required_argument, 0, OPT_AI_DEADLINE},
+        {"ai-weights", required_argument, 0, OPT_AI_WEIGHTS},
+        {"tablebase", required_argument, 0, OPT_TABLEBASE},
         {0, 0, 0, 0}
     };
     
@@ -59,6 +120,173 @@ bool CommandParser::parseArguments(int argc, char* argv[]) {
                 break;
             }
             
+            case OPT_RECORD:
+                config.record_filename = optarg;
+                break;
+                
+            case OPT_REPLAY:
+                config.replay_filename = optarg;
+                break;
+                
+            case OPT_REPLAY_PACE:
+                config.replay_pace_ms = std::atoi(optarg);
+                if (config.replay_pace_ms < 0) {
+                    printError("Invalid replay pace: " + std::string(optarg));
+                    config.valid_config = false;
+                    return false;
+                }
+                break;
+                
+            case OPT_SEEK:
+                config.replay_seek_turn = std::atoi(optarg);
+                if (config.replay_seek_turn < 0) {
+                    printError("Invalid seek turn: " + std::string(optarg));
+                    config.valid_config = false;
+                    return false;
+                }
+                break;
+                
+            case OPT_CHECKPOINT:
+                config.checkpoint_filename = optarg;
+                break;
+                
+            case OPT_CHECKPOINT_EVERY:
+                config.checkpoint_interval = std::atoi(optarg);
+                if (config.checkpoint_interval < 0) {
+                    printError("Invalid checkpoint interval: " + std::string(optarg));
+                    config.valid_config = false;
+                    return false;
+                }
+                break;
+                
+            case OPT_RESUME:
+                config.resume_filename = optarg;
+                break;
+                
+            case OPT_STATS:
+                config.collect_stats = true;
+                break;
+                
+            case OPT_SPECTATE:
+                config.spectate_target = optarg;
+                break;
+                
+            case OPT_SEED:
+                config.rng_seed = std::strtoull(optarg, nullptr, 10);
+                config.has_rng_seed = true;
+                break;
+                
+            case OPT_BENCH:
+                config.bench_name = optarg;
+                break;
+                
+            case OPT_TUI:
+                config.tui = true;
+                break;
+                
+            case OPT_FPS:
+                config.render_fps = std::atoi(optarg);
+                if (config.render_fps < 1 || config.render_fps > 1000) {
+                    printError("Invalid frame rate: " + std::string(optarg));
+                    config.valid_config = false;
+                    return false;
+                }
+                break;
+                
+            case OPT_RAW_INPUT:
+                config.raw_input = true;
+                break;
+                
+            case OPT_MOVE_TIMEOUT:
+                config.move_timeout_ms = std::atoi(optarg);
+                if (config.move_timeout_ms < 0) {
+                    printError("Invalid move timeout: " + std::string(optarg));
+                    config.valid_config = false;
+                    return false;
+                }
+                break;
+                
+            case OPT_NO_PONDER:
+                config.ponder = false;
+                break;
+                
+            case OPT_SHM:
+                config.shared_state_name = optarg ? optarg : SHARED_STATE_DEFAULT_NAME;
+                if (config.shared_state_name[0] != '/') {
+                    config.shared_state_name = "/" + config.shared_state_name;
+                }
+                break;
+                
+            case OPT_INPUT_SCRIPT:
+                config.input_script_filename = optarg;
+                break;
+                
+            case OPT_BATCH:
+                config.batch_directory = optarg;
+                break;
+                
+            case OPT_PROFILE:
+                config.profile = true;
+                break;
+                
+            case OPT_AI_LEVEL:
+                config.ai_level = std::atoi(optarg);
+                if (config.ai_level < 1 || config.ai_level > MAX_AI_LEVEL) {
+                    printError("Invalid AI level: " + std::string(optarg));
+                    config.valid_config = false;
+                    return false;
+                }
+                break;
+                
+            case OPT_AI_BUDGET:
+                if (!parseSearchBudget(optarg, config.ai_budget)) {
+                    printError("Invalid AI budget: " + std::string(optarg));
+                    config.valid_config = false;
+                    return false;
+                }
+                break;
+                
+            case OPT_AI_DEPTH:
+                config.ai_budget.depth = std::atoi(optarg);
+                if (config.ai_budget.depth < 1 || config.ai_budget.depth > MAX_SEARCH_DEPTH) {
+                    printError("Invalid AI depth: " + std::string(optarg));
+                    config.valid_config = false;
+                    return false;
+                }
+                break;
+                
+            case OPT_AI_THREADS:
+                config.ai_budget.threads = std::atoi(optarg);
+                if (config.ai_budget.threads < 1 || config.ai_budget.threads > MAX_SEARCH_THREADS) {
+                    printError("Invalid AI threads: " + std::string(optarg));
+                    config.valid_config = false;
+                    return false;
+                }
+                break;
+
+            case OPT_AI_DEADLINE:
+                config.ai_deadline_ms = std::atoi(optarg);
+                if (config.ai_deadline_ms < 1 || config.ai_deadline_ms > 60000) {
+                    printError("Invalid AI deadline: " + std::string(optarg));
+                    config.valid_config = false;
+                    return false;
+                }
+                break;
+                
+            case OPT_AI_WEIGHTS: {
+                std::string error;
+                if (!loadAIWeights(optarg, config.ai_weights, error)) {
+                    printError("Invalid AI weights: " + error);
+                    config.valid_config = false;
+                    return false;
+                }
+                break;
+            }
+
+            case OPT_TABLEBASE:
+                config.tablebase_filename = optarg;
+                break;
+                
             case '?':
                 // getopt_long has printed the error info
                 config.valid_config = false;
@@ -80,6 +308,33 @@ void CommandParser::printHelp() const {
     std::cout << "  --log-file <file>                    Log the game process to a file. (Default: tankwar.log)\n";
     std::cout << "  -m <mode> | --mode=<mode>            Specify the game mode (PVP/PVE/DEMO). (Default: PVP)\n";
     std::cout << "  -p <point> | --initial-life=<point>  Specify the initial life points of the tanks. (Default: 5)\n";
+    std::cout << "  --record=<file>                      Record the game to a compact replay file.\n";
+    std::cout << "  --replay=<file>                      Re-simulate a recorded game and verify every turn.\n";
+    std::cout << "  --replay-pace=<ms>                   Render the replay with a delay per turn. (Default: headless)\n";
+    std::cout << "  --seek=<turn>                        Jump to a turn of the replay before playing on.\n";
+    std::cout << "  --checkpoint=<file>                  Save the match to a checkpoint file on SIGTERM.\n";
+    std::cout << "  --checkpoint-every=<turns>           Also save the checkpoint every K turns. (Default: 0, off)\n";
+    std::cout << "  --resume=<file>                      Continue a match from a checkpoint file.\n";
+    std::cout << "  --stats                              Print match statistics when the game ends.\n";
+    std::cout << "  --profile                            Time each phase of a turn, print percentiles at the end.\n";
+    std::cout << "  --spectate=<fd|path>                 Stream the game as JSON lines to a descriptor or file.\n";
+    std::cout << "  --seed=<n>                           Seed for the AI random generator. (Default: random)\n";
+    std::cout << "  --tui                                Redraw the board in place, sending only changed cells.\n";
+    std::cout << "  --fps=<n>                            Draw DEMO games and replays on a separate thread at most n times a second.\n";
+    std::cout << "  --raw-input                          Single-key moves: W/A/D for tank A, arrows for tank B.\n";
+    std::cout << "  --move-timeout=<ms>                  With --raw-input, move forward if no key comes. (Default: 0, wait)\n";
+    std::cout << "  --ai-level=<1-5>                     AI strength; 4 searches with MCTS, 5 with minimax. (Default: 2)\n";
+    std::cout << "  --ai-budget=<n|nms>                  Search budget per move: n playouts or n milliseconds. (Default: 3000)\n";
+    std::cout << "  --ai-depth=<n>                       Turns the level-5 search looks ahead, 1-12. (Default: 4)\n";
+    std::cout << "  --ai-threads=<n>                     Threads of the level-5 search, 1-64; same moves for any n. (Default: 1)\n";
+    std::cout << "  --ai-deadline=<ms>                   Every AI move within ms, the level-2 move if the search has none. (Default: none)\n";
+    std::cout << "  --ai-weights=<file>                  Scoring weights of AI levels 2 and 3, as written by tankwar-tune.\n";
+    std::cout << "  --tablebase=<file>                   Endgame table from tankwar-tablebase; AI levels 2-5 play it on 6x6 and smaller maps.\n";
+    std::cout << "  --no-ponder                          In PVE, do not let the AI think during the human's turn.\n";
+    std::cout << "  --shm[=<name>]                       Publish live state for tankwar-monitor. (Default name: /tankwar)\n";
+    std::cout << "  --input-script=<file>                Take setups and human moves from a script file.\n";
+    std::cout << "  --batch=<dir>                        Play every input script in a directory headless and exit.\n";
+    std::cout << "  --bench=<name>                       Run a benchmark (render, tui, mcts, minimax, route, ai, threads, eval, deadline) and exit.\n";
     std::cout << std::endl;
 }
 
@@ -93,6 +348,12 @@ bool CommandParser::validateConfig() const {
     if (config.mode != PVP && config.mode != PVE && config.mode != DEMO) return false;
     if (!isValidLifePoints(config.initial_life_points)) return false;
     if (config.log_filename.empty()) return false;
+    if (!config.record_filename.empty() && !config.replay_filename.empty()) return false;
+    if (config.replay_seek_turn > 0 && config.replay_filename.empty()) return false;
+    if (!config.resume_filename.empty() &&
+        (!config.replay_filename.empty() || !config.record_filename.empty())) return false;
+    if (!config.input_script_filename.empty() &&
+        (!config.replay_filename.empty() || !config.resume_filename.empty())) return false;
     
     return true;
 }
@@ -118,6 +379,31 @@ void CommandParser::setDefaultConfig() {
     config.mode = PVP;
     config.initial_life_points = DEFAULT_LIFE_POINTS;
     config.log_filename = "tankwar.log";
+    config.record_filename.clear();
+    config.replay_filename.clear();
+    config.replay_pace_ms = -1;
+    config.replay_seek_turn = 0;
+    config.checkpoint_filename.clear();
+    config.checkpoint_interval = 0;
+    config.resume_filename.clear();
+    config.collect_stats = false;
+    config.profile = false;
+    config.spectate_target.clear();
+    config.rng_seed = 0;
+    config.has_rng_seed = false;
+    config.bench_name.clear();
+    config.tui = false;
+    config.render_fps = 0;
+    config.raw_input = false;
+    config.move_timeout_ms = 0;
+    config.ponder = true;
+    config.ai_level = 2;
+    config.ai_budget = SearchBudget();
+    config.ai_deadline_ms = 0;
+    config.tablebase_filename.clear();
+    config.shared_state_name.clear();
+    config.input_script_filename.clear();
+    config.batch_directory.clear();
     config.show_help = false;
     config.valid_config = true;
 }
@@ -132,6 +418,24 @@ bool CommandParser::isValidLifePoints(int points) const {
     return points > 0 && points <= 100; 
 }
 
+// "<n>" playouts or "<n>ms" of wall time per move
+bool CommandParser::parseSearchBudget(const std::string& text, SearchBudget& budget) const {
+    char* end = nullptr;
+    long value = std::strtol(text.c_str(), &end, 10);
+    if (end == text.c_str() || value <= 0 || value > 100000000) return false;
+    if (*end == '\0') {
+        budget.playouts = static_cast<int>(value);
+        budget.time_ms = 0;
+        return true;
+    }
+    if (std::strcmp(end, "ms") == 0) {
+        budget.playouts = 0;
+        budget.time_ms = static_cast<int>(value);
+        return true;
+    }
+    return false;
+}
+
 void CommandParser::printError(const std::string& error_message) const {
     std::cerr << program_name << ": " << error_message << std::endl;
     std::cerr << "Try '" << program_name << " --help' for more information." << std::endl;
@@ -4,12 +4,41 @@
 #define COMMAND_PARSER_H
 
 #include <string>
+#include <cstdint>
 #include "common.h"
+#include "search_budget.h"
+#include "ai_weights.h"
 
 struct GameConfig {
     GameMode mode;
     int initial_life_points;
     std::string log_filename;
+    std::string record_filename;
+    std::string replay_filename;
+    int replay_pace_ms; // < 0: headless
+    int replay_seek_turn;
+    std::string checkpoint_filename;
+    int checkpoint_interval;
+    std::string resume_filename;
+    bool collect_stats;
+    bool profile;
+    std::string spectate_target;
+    uint64_t rng_seed;
+    bool has_rng_seed;
+    std::string bench_name;
+    bool tui;
+    int render_fps;
+    bool raw_input;
+    int move_timeout_ms;
+    bool ponder;
+    int ai_level;
+    SearchBudget ai_budget;
+    int ai_deadline_ms;
+    AIWeights ai_weights;
+    std::string tablebase_filename;
+    std::string shared_state_name;
+    std::string input_script_filename;
+    std::string batch_directory;
     bool show_help;
     bool valid_config;
     
@@ -17,6 +46,20 @@ struct GameConfig {
         mode(PVP), 
         initial_life_points(DEFAULT_LIFE_POINTS),
         log_filename("tankwar.log"),
+        replay_pace_ms(-1),
+        replay_seek_turn(0),
+        checkpoint_interval(0),
+        collect_stats(false),
+        profile(false),
+        rng_seed(0),
+        has_rng_seed(false),
+        tui(false),
+        render_fps(0),
+        raw_input(false),
+        move_timeout_ms(0),
+        ponder(true),
+        ai_level(2),
+        ai_deadline_ms(0),
         show_help(false),
         valid_config(true) {}
 };
@@ -51,6 +94,7 @@ private:
     void setDefaultConfig();
     bool isValidMode(const std::string& mode_str) const;
     bool isValidLifePoints(int points) const;
+    bool parseSearchBudget(const std::string& text, SearchBudget& budget) const;
     void printError(const std::string& error_message) const;
 };
 
@@ -22,6 +22,16 @@ Direction turnRight(Direction dir) {
     }
 }
 
+const char* directionName(Direction dir) {
+    switch (dir) {
+        case D_Left:  return "Left";
+        case D_Up:    return "Up";
+        case D_Right: return "Right";
+        case D_Down:  return "Down";
+        default:      return "Unknown";
+    }
+}
+
 Direction getOppositeDirection(Direction dir) {
     switch (dir) {
         case D_Left:  return D_Right;
@@ -30,4 +40,18 @@ Direction getOppositeDirection(Direction dir) {
         case D_Down:  return D_Up;
         default:      return dir;
     }
-}
\ No newline at end of file
+}
+
+void appendInt(std::string& out, int value) {
+    char digits[12];
+    int length = 0;
+    unsigned int magnitude = (value < 0) ? 0u - static_cast<unsigned int>(value)
+                                         : static_cast<unsigned int>(value);
+    do {
+        digits[length++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+
+    if (value < 0) out += '-';
+    while (length > 0) out += digits[--length];
+}
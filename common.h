@@ -3,6 +3,8 @@
 #ifndef COMMON_H
 #define COMMON_H
 
+#include <string>
+
 enum Direction {
     D_Left = 0, D_Up = 1, D_Right = 2, D_Down = 3    
 };
@@ -29,9 +31,17 @@ const int SHOOT_INTERVAL = 1;
 const int MAP_SHRINK_INTERVAL = 6;
 const int OUT_OF_MAP_DAMAGE = 1;
 const int BULLET_SPAWN_DISTANCE = 2;
+const int BULLET_AREA = INITIAL_MAP_SIZE + 20; // bullets fly on until they leave this square
+// both tanks fire every turn and a bullet crosses the area at most once, so no
+// more are ever alive together; buffers sized by it never regrow mid-game
+const int MAX_LIVE_BULLETS = 2 * 2 * (BULLET_AREA + BULLET_OUT_OF_BOUNDS_OFFSET) / BULLET_SPEED;
 
 Direction turnLeft(Direction dir);
 Direction turnRight(Direction dir);
 Direction getOppositeDirection(Direction dir);
+const char* directionName(Direction dir);
+
+// decimal formatting without the temporary std::to_string builds
+void appendInt(std::string& out, int value);
 
 #endif // COMMON_H
\ No newline at end of file
@@ -0,0 +1,22 @@
+// danger_map.cpp
+
+#include "danger_map.h"
+#include <cstring>
+
+void DangerMap::clear() {
+    std::memset(bullets, 0, sizeof(bullets));
+    std::memset(rows, 0, sizeof(rows));
+}
+
+void DangerMap::project() {
+    const uint64_t full_row = (static_cast<uint64_t>(1) << INITIAL_MAP_SIZE) - 1;
+    for (int t = 0; t < TURNS; t++) {
+        int shift = BULLET_SPEED * (t + 1);
+        for (int y = 0; y < INITIAL_MAP_SIZE; y++) {
+            int row = y + MARGIN;
+            uint64_t landing = (bullets[D_Right][row] << shift) | (bullets[D_Left][row] >> shift) |
+                               bullets[D_Down][row - shift] | bullets[D_Up][row + shift];
+            rows[t][y] = static_cast<uint32_t>((landing >> MARGIN) & full_row);
+        }
+    }
+}
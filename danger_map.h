@@ -0,0 +1,67 @@
+// danger_map.h
+
+#ifndef DANGER_MAP_H
+#define DANGER_MAP_H
+
+#include <cstdint>
+#include "common.h"
+
+// Where enemy bullets will land in the next TURNS turns, as one bit per
+// (turn, cell) of the full-size map. Bullets are first sorted by direction
+// into row masks; projecting them is then a shift per row and turn, since a
+// bullet flies BULLET_SPEED cells a turn in a straight line. A bullet only
+// hits the tank on the cell it lands on, so that is all that is marked.
+// The first TURNS are projected into a table; isHitOnTurn traces the masks
+// directly for route planning up to HORIZON turns ahead.
+class DangerMap {
+public:
+    static const int TURNS = 3;
+    static const int HORIZON = 12;
+    // bullets this far outside the map can still land on it within HORIZON
+    static const int MARGIN = BULLET_SPEED * HORIZON;
+
+private:
+    static const int SPAN = INITIAL_MAP_SIZE + 2 * MARGIN;
+    static_assert(SPAN <= 64, "one 64-bit mask per row of bullets");
+
+    uint64_t bullets[4][SPAN];               // by direction and row + MARGIN, bit x + MARGIN
+    uint32_t rows[TURNS][INITIAL_MAP_SIZE];  // bit x of rows[t][y]: a bullet lands on (x, y) in turn t + 1
+
+public:
+    DangerMap() { clear(); }
+
+    void clear();
+    // a bullet at (x, y) that has not moved yet this turn; project() to see it
+    void addBullet(int x, int y, Direction dir) {
+        // negative coordinates wrap to large unsigned ones, one compare per axis
+        unsigned column = static_cast<unsigned>(x + MARGIN);
+        unsigned row = static_cast<unsigned>(y + MARGIN);
+        if (column < SPAN && row < SPAN) bullets[dir][row] |= static_cast<uint64_t>(1) << column;
+    }
+    // recomputes the landing cells of every bullet added so far
+    void project();
+
+    // turn 1 is the turn being decided
+    bool isHit(int turn, int x, int y) const {
+        if (static_cast<unsigned>(x) >= INITIAL_MAP_SIZE || static_cast<unsigned>(y) >= INITIAL_MAP_SIZE) return false;
+        return (rows[turn - 1][y] >> x) & 1;
+    }
+    // in how many of the first turns a bullet lands on (x, y)
+    int hitCount(int x, int y, int turns) const {
+        int count = 0;
+        for (int t = 1; t <= turns; t++) count += isHit(t, x, y);
+        return count;
+    }
+    bool isHitWithin(int x, int y, int turns) const { return hitCount(x, y, turns) > 0; }
+    // same as isHit for any turn up to HORIZON, without project(): a bullet lands
+    // on (x, y) after turn * BULLET_SPEED cells if it started that far behind it
+    bool isHitOnTurn(int turn, int x, int y) const {
+        if (static_cast<unsigned>(x) >= INITIAL_MAP_SIZE || static_cast<unsigned>(y) >= INITIAL_MAP_SIZE) return false;
+        int column = x + MARGIN, row = y + MARGIN, shift = BULLET_SPEED * turn;
+        uint64_t bit = static_cast<uint64_t>(1) << column;
+        return ((bullets[D_Right][row] << shift) & bit) || ((bullets[D_Left][row] >> shift) & bit) ||
+               (bullets[D_Down][row - shift] & bit) || (bullets[D_Up][row + shift] & bit);
+    }
+};
+
+#endif // DANGER_MAP_H
@@ -0,0 +1,339 @@
+// endgame_table.cpp
+
+#include "endgame_table.h"
+#include "game_core.h"
+#include "worker_pool.h"
+#include "binary_io.h"
+#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+
+static const int DX[4] = {-1, 0, 1, 0}; // by Direction: left, up, right, down
+static const int DY[4] = {0, -1, 0, 1};
+
+static const char ENDGAME_MAGIC[4] = {'T', 'W', 'E', 'G'};
+
+static_assert(SHOOT_INTERVAL == 1, "positions leave out the shoot counters: every tank fires every turn");
+static_assert(EndgameTable::FIRING_RANGE < EndgameTable::SIZE &&
+              EndgameTable::FIRING_RANGE + BULLET_SPEED >= EndgameTable::SIZE,
+              "a bullet fired inside the square must land in it at most once, the turn it is fired");
+static_assert(INITIAL_MAP_SIZE % 2 == 0 && INITIAL_MAP_SIZE >= ENDGAME_MAP_SIZE,
+              "shrinking by 2, the map passes through 6x6 and 4x4 on its way to 2x2");
+
+static uint64_t fnv1a(const int8_t* data, size_t size) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// one turn further from the end, whoever wins
+static int8_t later(int8_t value) {
+    if (value > 0) return static_cast<int8_t>(value < 127 ? value + 1 : 127);
+    if (value < 0) return static_cast<int8_t>(value > -127 ? value - 1 : -127);
+    return 0;
+}
+
+static bool inSquare(int x, int y) {
+    return x >= EndgameTable::MIN && x <= EndgameTable::MAX && y >= EndgameTable::MIN && y <= EndgameTable::MAX;
+}
+
+// lands inside the square some turn from now on, flying BULLET_SPEED a turn;
+// the square is wider than a step, so a bullet flying over it lands in it
+static bool landsInSquare(const Bullet& bullet) {
+    int x = bullet.getX(), y = bullet.getY();
+    switch (bullet.getDirection()) {
+        case D_Left:  return y >= EndgameTable::MIN && y <= EndgameTable::MAX && x - BULLET_SPEED >= EndgameTable::MIN;
+        case D_Right: return y >= EndgameTable::MIN && y <= EndgameTable::MAX && x + BULLET_SPEED <= EndgameTable::MAX;
+        case D_Up:    return x >= EndgameTable::MIN && x <= EndgameTable::MAX && y - BULLET_SPEED >= EndgameTable::MIN;
+        case D_Down:  return x >= EndgameTable::MIN && x <= EndgameTable::MAX && y + BULLET_SPEED <= EndgameTable::MAX;
+    }
+    return true;
+}
+
+EndgameTable::EndgameTable() : entries(nullptr), max_life(0), tank_states(0) {}
+
+int EndgameTable::layerOf(int map_size, int map_turn_count) {
+    if (map_size == SIZE) return map_turn_count % MAP_SHRINK_INTERVAL;
+    if (map_size == SIZE - 2) return MAP_SHRINK_INTERVAL + map_turn_count % MAP_SHRINK_INTERVAL;
+    if (map_size == 2) return LAYERS - 1;
+    return -1;
+}
+
+int EndgameTable::layerMapSize(int layer) {
+    if (layer < MAP_SHRINK_INTERVAL) return SIZE;
+    if (layer < 2 * MAP_SHRINK_INTERVAL) return SIZE - 2;
+    return 2;
+}
+
+bool EndgameTable::applyMove(Tank& tank, Move move) {
+    switch (move) {
+        case M_Forward:
+            tank.x += DX[tank.direction] * TANK_SPEED;
+            tank.y += DY[tank.direction] * TANK_SPEED;
+            break;
+        case M_Left:  tank.direction = turnLeft(tank.direction); break;
+        case M_Right: tank.direction = turnRight(tank.direction); break;
+    }
+    return inSquare(tank.x, tank.y);
+}
+
+// collision, the two bullets fired this turn, the map's edge, as in
+// GameCore::finishTurn; older bullets have left the square
+GameResult EndgameTable::finishTurn(int layer, Tank& a, Tank& b) {
+    if (a.x == b.x && a.y == b.y) {
+        if (a.life_points > b.life_points) return TANK_A_WIN;
+        if (b.life_points > a.life_points) return TANK_B_WIN;
+        return DRAW;
+    }
+
+    bool a_hit = a.x == b.x + DX[b.direction] * FIRING_RANGE && a.y == b.y + DY[b.direction] * FIRING_RANGE;
+    bool b_hit = b.x == a.x + DX[a.direction] * FIRING_RANGE && b.y == a.y + DY[a.direction] * FIRING_RANGE;
+    if (a_hit) a.life_points -= BULLET_DAMAGE;
+    if (b_hit) b.life_points -= BULLET_DAMAGE;
+
+    int size = layerMapSize(layer);
+    int low = INITIAL_MAP_SIZE / 2 - size / 2, high = low + size - 1;
+    Tank* tanks[2] = {&a, &b};
+    for (Tank* tank : tanks) {
+        if (tank->x < low || tank->x > high || tank->y < low || tank->y > high) tank->life_points -= OUT_OF_MAP_DAMAGE;
+        if (tank->life_points < 0) tank->life_points = 0;
+    }
+
+    if (a.life_points == 0 && b.life_points == 0) return DRAW;
+    if (a.life_points == 0) return TANK_B_WIN;
+    if (b.life_points == 0) return TANK_A_WIN;
+    return GAME_CONTINUE;
+}
+
+EndgameTable::Tank EndgameTable::tankAt(int index) const {
+    Tank tank;
+    tank.direction = static_cast<Direction>(index % 4);
+    index /= 4;
+    tank.x = MIN + index % SIZE;
+    index /= SIZE;
+    tank.y = MIN + index % SIZE;
+    tank.life_points = 1 + index / SIZE;
+    return tank;
+}
+
+int8_t EndgameTable::valueAfter(const int8_t* values, int layer, const Tank& a, const Tank& b, Move move_b) const {
+    Tank next_a = a, next_b = b;
+    if (!applyMove(next_b, move_b)) return ILLEGAL;
+    switch (finishTurn(layer, next_a, next_b)) {
+        case TANK_A_WIN: return 1;
+        case TANK_B_WIN: return -1;
+        case DRAW:       return 0;
+        default:         return later(values[indexOf(nextLayer(layer), next_a, next_b)]);
+    }
+}
+
+// A's best move against B's best answer to it; each tank can always turn in place
+int8_t EndgameTable::solve(const int8_t* values, int layer, const Tank& a, const Tank& b) const {
+    int8_t best = ILLEGAL;
+    for (int move_a = 0; move_a < 3; move_a++) {
+        Tank moved_a = a;
+        if (!applyMove(moved_a, static_cast<Move>(move_a))) continue;
+        int8_t worst = ILLEGAL;
+        for (int move_b = 0; move_b < 3; move_b++) {
+            int8_t value = valueAfter(values, layer, moved_a, b, static_cast<Move>(move_b));
+            if (value != ILLEGAL && (worst == ILLEGAL || rank(value) < rank(worst))) worst = value;
+        }
+        if (best == ILLEGAL || rank(worst) > rank(best)) best = worst;
+    }
+    return best;
+}
+
+void EndgameTable::solveRow(const int8_t* values, int layer, int a_index, int8_t* row) const {
+    Tank a = tankAt(a_index);
+    for (int b_index = 0; b_index < tank_states; b_index++) {
+        Tank b = tankAt(b_index);
+        row[b_index] = (a.x == b.x && a.y == b.y) ? 0 : solve(values, layer, a, b);
+    }
+}
+
+// one pass over a layer: row a of the output from the values of the input
+class EndgameSolveJob : public WorkerPool::Job {
+public:
+    const EndgameTable& table;
+    const int8_t* values;
+    int layer;
+    int8_t* output;
+
+    EndgameSolveJob(const EndgameTable& table, const int8_t* values, int layer, int8_t* output)
+        : table(table), values(values), layer(layer), output(output) {}
+
+    void runTask(int task) override {
+        table.solveRow(values, layer, task, output + static_cast<size_t>(task) * table.tank_states);
+    }
+
+    void run(WorkerPool* pool) {
+        if (pool) {
+            pool->run(*this, table.tank_states);
+        } else {
+            for (int task = 0; task < table.tank_states; task++) runTask(task);
+        }
+    }
+};
+
+void EndgameTable::generate(int life_limit, WorkerPool* pool, Stats& stats) {
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+
+    file.close();
+    max_life = life_limit;
+    tank_states = SIZE * SIZE * 4 * max_life;
+    size_t layer_entries = static_cast<size_t>(tank_states) * tank_states;
+    solved.assign(getEntryCount(), 0);
+    entries = solved.data();
+    stats = Stats();
+
+    // 2x2 for good: from all draws, each pass sees one turn further, until
+    // the longest forced result is found and nothing changes any more
+    int last = LAYERS - 1;
+    int8_t* last_layer = solved.data() + last * layer_entries;
+    std::vector<int8_t> next(layer_entries);
+    for (;;) {
+        EndgameSolveJob job(*this, solved.data(), last, next.data());
+        job.run(pool);
+        stats.passes++;
+        if (std::memcmp(next.data(), last_layer, layer_entries) == 0) break;
+        std::memcpy(last_layer, next.data(), layer_entries);
+    }
+
+    // then back in time, each layer from the one after it
+    for (int layer = last - 1; layer >= 0; layer--) {
+        EndgameSolveJob job(*this, solved.data(), layer, solved.data() + layer * layer_entries);
+        job.run(pool);
+        stats.passes++;
+    }
+
+    for (size_t i = 0; i < solved.size(); i++) {
+        size_t pair = i % layer_entries;
+        Tank a = tankAt(static_cast<int>(pair / tank_states)), b = tankAt(static_cast<int>(pair % tank_states));
+        if (a.x == b.x && a.y == b.y) continue;
+        int8_t value = solved[i];
+        if (value > 0) stats.wins++;
+        else if (value < 0) stats.losses++;
+        else stats.draws++;
+        stats.longest = std::max(stats.longest, std::abs(static_cast<int>(value)));
+    }
+    stats.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+bool EndgameTable::save(const std::string& filename) const {
+    if (!entries) return false;
+    std::vector<uint8_t> header;
+    for (int i = 0; i < 4; i++) appendU8(header, static_cast<uint8_t>(ENDGAME_MAGIC[i]));
+    appendU8(header, static_cast<uint8_t>(ENDGAME_VERSION));
+    appendU8(header, static_cast<uint8_t>(max_life));
+    appendU8(header, static_cast<uint8_t>(LAYERS));
+    appendU8(header, 0);
+    appendU32(header, static_cast<uint32_t>(getEntryCount()));
+    appendU64(header, fnv1a(entries, getEntryCount()));
+
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+    out.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+    out.write(reinterpret_cast<const char*>(entries), static_cast<std::streamsize>(getEntryCount()));
+    return static_cast<bool>(out.flush());
+}
+
+bool EndgameTable::open(const std::string& filename, std::string& error) {
+    solved.clear();
+    entries = nullptr;
+    if (!file.open(filename)) {
+        error = filename + ": cannot read file";
+        return false;
+    }
+
+    const uint8_t* data = file.getData();
+    size_t size = file.getSize();
+    bool valid = size >= static_cast<size_t>(ENDGAME_HEADER_SIZE) && std::memcmp(data, ENDGAME_MAGIC, 4) == 0;
+    if (!valid) {
+        error = filename + ": not a tablebase";
+    } else if (data[4] != ENDGAME_VERSION || data[6] != LAYERS) {
+        error = filename + ": made for another version of the game";
+        valid = false;
+    } else if (data[5] < 1 || data[5] > MAX_LIFE) {
+        error = filename + ": bad header";
+        valid = false;
+    } else {
+        max_life = data[5];
+        tank_states = SIZE * SIZE * 4 * max_life;
+        if (readU32(data + 8) != getEntryCount() || size != getFileSize()) {
+            error = filename + ": truncated or damaged";
+            valid = false;
+        }
+    }
+    if (!valid) {
+        file.close();
+        max_life = tank_states = 0;
+        return false;
+    }
+
+    entries = reinterpret_cast<const int8_t*>(data + ENDGAME_HEADER_SIZE);
+    return true;
+}
+
+bool EndgameTable::verifyChecksum() const {
+    if (!file.isOpen()) return entries != nullptr;
+    return readU64(file.getData() + 12) == fnv1a(entries, getEntryCount());
+}
+
+bool EndgameTable::probe(const GameCore& game, char tank_id, int8_t values[3]) const {
+    if (!entries) return false;
+    const GameMap& map = game.getGameMap();
+    int layer = layerOf(map.getCurrentSize(), map.getTurnCount());
+    if (layer < 0) return false;
+
+    const ::Tank* sources[2] = {&game.getTankA(), &game.getTankB()};
+    Tank tanks[2];
+    for (int i = 0; i < 2; i++) {
+        tanks[i].x = sources[i]->getX();
+        tanks[i].y = sources[i]->getY();
+        tanks[i].direction = sources[i]->getDirection();
+        tanks[i].life_points = sources[i]->getLifePoints();
+        if (!inSquare(tanks[i].x, tanks[i].y) || tanks[i].life_points < 1 || tanks[i].life_points > max_life) return false;
+    }
+    // A may have driven onto B; B's move still decides how that ends
+    if (tank_id == 'A' && tanks[0].x == tanks[1].x && tanks[0].y == tanks[1].y) return false;
+
+    // when B decides, A's bullet of this turn is already out; the table plays it
+    bool after_a = (tank_id == 'B');
+    int fresh_x = tanks[0].x + DX[tanks[0].direction] * BULLET_SPAWN_DISTANCE;
+    int fresh_y = tanks[0].y + DY[tanks[0].direction] * BULLET_SPAWN_DISTANCE;
+    for (const Bullet& bullet : game.getBullets()) {
+        if (!bullet.isActive()) continue;
+        if (after_a && bullet.getOwnerId() == 'A' && bullet.getX() == fresh_x && bullet.getY() == fresh_y &&
+            bullet.getDirection() == tanks[0].direction) {
+            after_a = false; // only the one
+            continue;
+        }
+        if (landsInSquare(bullet)) return false;
+    }
+
+    if (tank_id == 'A') {
+        for (int move_a = 0; move_a < 3; move_a++) {
+            Tank moved_a = tanks[0];
+            values[move_a] = ILLEGAL;
+            if (!applyMove(moved_a, static_cast<Move>(move_a))) continue;
+            for (int move_b = 0; move_b < 3; move_b++) {
+                int8_t value = valueAfter(entries, layer, moved_a, tanks[1], static_cast<Move>(move_b));
+                if (value != ILLEGAL && (values[move_a] == ILLEGAL || rank(value) < rank(values[move_a]))) {
+                    values[move_a] = value;
+                }
+            }
+        }
+    } else {
+        for (int move_b = 0; move_b < 3; move_b++) {
+            int8_t value = valueAfter(entries, layer, tanks[0], tanks[1], static_cast<Move>(move_b));
+            values[move_b] = (value == ILLEGAL) ? ILLEGAL : static_cast<int8_t>(-value);
+        }
+    }
+    return true;
+}
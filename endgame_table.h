@@ -0,0 +1,131 @@
+// endgame_table.h
+
+#ifndef ENDGAME_TABLE_H
+#define ENDGAME_TABLE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "common.h"
+#include "mapped_file.h"
+
+class GameCore;
+class WorkerPool;
+
+// Exact values of the endgame once the map is down to 6x6, found by retrograde
+// analysis and kept in a file that is mapped, not read.
+//
+// No bullet is part of a position. A tank fires every turn, and its bullet
+// lands FIRING_RANGE cells ahead that same turn and BULLET_SPEED further each
+// turn after, by then outside a 6x6 square. So while both tanks stay inside the
+// square the map has at size 6, only the two bullets of the current turn can
+// hit, and those follow from the tanks. That is the game the table solves: a
+// move out of the square is not a move in it, and a position is only probed
+// when no older bullet can still land inside. Otherwise the AI plays its level.
+//
+// A position is the board as A decides: the layer (map size and turns since
+// the last shrink), then each tank's cell, direction and life. Layers follow
+// in time, six turns of 6x6, six of 4x4, then 2x2 for good, so each is solved
+// in one pass from the next; the 2x2 layer leads back to itself and is
+// iterated until nothing changes. Passes are split over a WorkerPool by A's
+// state, and each reads only the previous pass, so any thread count gives the
+// same file.
+//
+// File layout (little-endian):
+//   header   "TWEG", version, max life, layer count, reserved byte,
+//            entry count (32 bits), FNV-1a of the entries (64 bits)
+//   entries  one signed byte per position, for A: n > 0 wins in n turns with
+//            best play, n < 0 loses in -n turns, 0 a draw
+//   indexed  (layer * tank states + state of A) * tank states + state of B,
+//            a tank state being (((life - 1) * 6 + y - 5) * 6 + x - 5) * 4 + direction
+
+const int ENDGAME_VERSION = 1;
+const int ENDGAME_HEADER_SIZE = 20;
+const int ENDGAME_MAP_SIZE = 6;
+
+class EndgameTable {
+public:
+    static const int SIZE = ENDGAME_MAP_SIZE;                 // cells a side of the square
+    static const int MIN = INITIAL_MAP_SIZE / 2 - SIZE / 2;   // its first row and column
+    static const int MAX = MIN + SIZE - 1;
+    static const int LAYERS = 2 * MAP_SHRINK_INTERVAL + 1;
+    static const int FIRING_RANGE = BULLET_SPAWN_DISTANCE + BULLET_SPEED;
+    static const int8_t ILLEGAL = -128;                       // a move out of the square
+    static const int MAX_LIFE = 20;
+
+    struct Tank {
+        int x, y;
+        Direction direction;
+        int life_points;
+    };
+
+    struct Stats {
+        double seconds;
+        int passes;        // over a whole layer, the 2x2 one's repeats included
+        int longest;       // turns of the longest forced result
+        uint64_t wins, losses, draws; // for A, over positions with the tanks apart
+        Stats() : seconds(0), passes(0), longest(0), wins(0), losses(0), draws(0) {}
+    };
+
+private:
+    MappedFile file;
+    std::vector<int8_t> solved; // when generated here rather than opened
+    const int8_t* entries;
+    int max_life;
+    int tank_states;
+
+public:
+    EndgameTable();
+
+    EndgameTable(const EndgameTable&) = delete;
+    EndgameTable& operator=(const EndgameTable&) = delete;
+
+    // every position with both lives up to max_life; pool may be null
+    void generate(int max_life, WorkerPool* pool, Stats& stats);
+    bool save(const std::string& filename) const;
+    // maps the file; false with error set if it is not a table of this build
+    bool open(const std::string& filename, std::string& error);
+    // reads every entry, so only worth it once after writing or copying a file
+    bool verifyChecksum() const;
+
+    bool isLoaded() const { return entries != nullptr; }
+    int getMaxLife() const { return max_life; }
+    size_t getEntryCount() const { return static_cast<size_t>(LAYERS) * tank_states * tank_states; }
+    size_t getFileSize() const { return ENDGAME_HEADER_SIZE + getEntryCount(); }
+
+    // the value of each move of tank_id, for that tank, ILLEGAL for a move out
+    // of the square. game is where the AI decides: the turn begun and, for B,
+    // A's move made. false when the table does not cover the position.
+    bool probe(const GameCore& game, char tank_id, int8_t values[3]) const;
+    // A to move; the tanks on different cells inside the square
+    int8_t lookup(int layer, const Tank& a, const Tank& b) const { return entries[indexOf(layer, a, b)]; }
+
+    // what a value is worth to the side it is for: sooner wins, later losses
+    static int rank(int8_t value) { return value > 0 ? 1000 - value : value < 0 ? -1000 - value : 0; }
+
+    // the rules of a turn inside the square, as GameCore plays them
+    static int layerOf(int map_size, int map_turn_count); // -1 for a larger map
+    static int nextLayer(int layer) { return layer + 1 < LAYERS ? layer + 1 : layer; }
+    static int layerMapSize(int layer);
+    static bool applyMove(Tank& tank, Move move); // false if it leaves the square
+    static GameResult finishTurn(int layer, Tank& a, Tank& b);
+
+private:
+    int tankIndex(const Tank& tank) const {
+        return (((tank.life_points - 1) * SIZE + tank.y - MIN) * SIZE + tank.x - MIN) * 4 + tank.direction;
+    }
+    size_t indexOf(int layer, const Tank& a, const Tank& b) const {
+        return (static_cast<size_t>(layer) * tank_states + tankIndex(a)) * tank_states + tankIndex(b);
+    }
+    Tank tankAt(int index) const;
+    // for A, once A has moved to a and B makes move_b from b; ILLEGAL if B leaves
+    int8_t valueAfter(const int8_t* values, int layer, const Tank& a, const Tank& b, Move move_b) const;
+    // A to move, from the values of the next layer
+    int8_t solve(const int8_t* values, int layer, const Tank& a, const Tank& b) const;
+    void solveRow(const int8_t* values, int layer, int a_index, int8_t* row) const;
+
+    friend class EndgameSolveJob;
+};
+
+#endif // ENDGAME_TABLE_H
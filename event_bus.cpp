@@ -0,0 +1,102 @@
+// event_bus.cpp
+
+#include "event_bus.h"
+#include <chrono>
+
+static const uint64_t SLOT_BEING_WRITTEN = ~static_cast<uint64_t>(0);
+
+EventBus::EventBus(size_t capacity) : head(0), closed(false) {
+    size_t size = 1;
+    while (size < capacity) size <<= 1;
+    slots = std::vector<Slot>(size);
+    mask = size - 1;
+}
+
+EventBus::~EventBus() {}
+
+void EventBus::publish(const GameEvent& event) {
+    uint64_t sequence = head.load(std::memory_order_relaxed);
+    Slot& slot = slots[sequence & mask];
+
+    // a reader still copying the old event sees the marker and knows it was lapped
+    slot.sequence.store(SLOT_BEING_WRITTEN, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.event = event;
+    slot.sequence.store(sequence + 1, std::memory_order_release);
+    head.store(sequence + 1, std::memory_order_release);
+}
+
+void EventBus::close() {
+    closed.store(true, std::memory_order_release);
+}
+
+EventBus::ReadResult EventBus::read(uint64_t sequence, GameEvent& event) const {
+    const Slot& slot = slots[sequence & mask];
+
+    uint64_t before = slot.sequence.load(std::memory_order_acquire);
+    if (before < sequence + 1) return READ_EMPTY;
+    if (before > sequence + 1) return READ_OVERRUN;
+
+    event = slot.event;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t after = slot.sequence.load(std::memory_order_relaxed);
+    return (after == before) ? READ_OK : READ_OVERRUN;
+}
+
+EventSubscriber::EventSubscriber(const std::string& subscriber_name, EventBus& event_bus,
+                                 GameEventHandler& event_handler)
+    : name(subscriber_name), bus(event_bus), handler(event_handler),
+      cursor(event_bus.getHead()), dropped_events(0), handled_events(0) {
+}
+
+EventSubscriber::~EventSubscriber() {
+    join();
+}
+
+void EventSubscriber::start() {
+    if (!worker.joinable()) {
+        worker = std::thread(&EventSubscriber::run, this);
+    }
+}
+
+void EventSubscriber::join() {
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void EventSubscriber::run() {
+    const uint64_t capacity = bus.getCapacity();
+    int idle_rounds = 0;
+
+    while (true) {
+        uint64_t head = bus.getHead();
+        if (cursor == head) {
+            if (bus.isClosed() && cursor == bus.getHead()) break;
+
+            // back off gradually so an idle consumer costs almost nothing
+            if (++idle_rounds < 64) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+            continue;
+        }
+        idle_rounds = 0;
+
+        if (head - cursor > capacity) {
+            uint64_t dropped = head - cursor - capacity;
+            cursor = head - capacity;
+            dropped_events += dropped;
+            handler.handleOverrun(dropped);
+        }
+
+        GameEvent event;
+        EventBus::ReadResult result = bus.read(cursor, event);
+        if (result != EventBus::READ_OK) continue; // lapped while reading, recheck the lag
+
+        handler.handleEvent(event);
+        cursor++;
+        handled_events++;
+    }
+}
@@ -0,0 +1,78 @@
+// event_bus.h
+
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include "game_event.h"
+
+// Single-producer broadcast ring. The game loop publishes without ever
+// blocking; every subscriber follows with its own cursor on its own thread.
+// A subscriber that falls more than a ring's worth behind loses the oldest
+// events, and the loss is counted and reported to its handler.
+// Installed as the GameCore observer, it forwards every rule event.
+class EventBus : public GameEventHandler {
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence; // 1 + the sequence number stored, 0 while empty
+        GameEvent event;
+        Slot() : sequence(0) {}
+    };
+
+    std::vector<Slot> slots;
+    uint64_t mask;
+    std::atomic<uint64_t> head; // next sequence number to publish
+    std::atomic<bool> closed;
+
+public:
+    explicit EventBus(size_t capacity = 16384);
+    ~EventBus();
+
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
+    void publish(const GameEvent& event);
+    void handleEvent(const GameEvent& event) override { publish(event); }
+    void close();
+
+    bool isClosed() const { return closed.load(std::memory_order_acquire); }
+    uint64_t getHead() const { return head.load(std::memory_order_acquire); }
+    size_t getCapacity() const { return slots.size(); }
+
+    // outcome of reading the event at a sequence number
+    enum ReadResult { READ_OK, READ_EMPTY, READ_OVERRUN };
+    ReadResult read(uint64_t sequence, GameEvent& event) const;
+};
+
+class EventSubscriber {
+private:
+    std::string name;
+    EventBus& bus;
+    GameEventHandler& handler;
+    uint64_t cursor;
+    std::atomic<uint64_t> dropped_events;
+    std::atomic<uint64_t> handled_events;
+    std::thread worker;
+
+public:
+    EventSubscriber(const std::string& subscriber_name, EventBus& event_bus, GameEventHandler& event_handler);
+    ~EventSubscriber();
+
+    void start();
+    // waits until everything published before the bus was closed is handled
+    void join();
+
+    std::string getName() const { return name; }
+    uint64_t getDroppedEvents() const { return dropped_events.load(); }
+    uint64_t getHandledEvents() const { return handled_events.load(); }
+
+private:
+    void run();
+};
+
+#endif // EVENT_BUS_H
@@ -0,0 +1,65 @@
+// fixed_list.h
+
+#ifndef FIXED_LIST_H
+#define FIXED_LIST_H
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// A vector with its capacity inline: it never allocates, and a copy copies
+// only the live items. Adding to a full list drops the item and returns false.
+// Meant for small plain structs, which is all the AI keeps.
+template <typename T, size_t N>
+class FixedList {
+    static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value,
+                  "items are copied with memcpy and never destroyed");
+
+private:
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage[N];
+    size_t count;
+
+public:
+    FixedList() : count(0) {}
+    FixedList(const FixedList& other) : count(other.count) {
+        std::memcpy(storage, other.storage, count * sizeof(T));
+    }
+    FixedList& operator=(const FixedList& other) {
+        count = other.count;
+        std::memcpy(storage, other.storage, count * sizeof(T));
+        return *this;
+    }
+
+    bool push_back(const T& item) { return emplace_back(item); }
+    template <typename... Args>
+    bool emplace_back(Args&&... args) {
+        if (count == N) return false;
+        new (&storage[count++]) T(std::forward<Args>(args)...);
+        return true;
+    }
+
+    void clear() { count = 0; }
+    // keeps the first new_size items; never grows the list
+    void truncate(size_t new_size) { if (new_size < count) count = new_size; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == N; }
+    static size_t capacity() { return N; }
+
+    T& operator[](size_t i) { return data()[i]; }
+    const T& operator[](size_t i) const { return data()[i]; }
+    T& back() { return data()[count - 1]; }
+    const T& back() const { return data()[count - 1]; }
+
+    T* data() { return reinterpret_cast<T*>(storage); }
+    const T* data() const { return reinterpret_cast<const T*>(storage); }
+    T* begin() { return data(); }
+    T* end() { return data() + count; }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + count; }
+};
+
+#endif // FIXED_LIST_H
@@ -0,0 +1,260 @@
+// game_core.cpp
+
+#include "game_core.h"
+#include <algorithm>
+
+GameCore::GameCore()
+    : game_map(INITIAL_MAP_SIZE), current_turn(0), observer(nullptr) {
+    bullets.reserve(MAX_LIVE_BULLETS);
+}
+
+GameCore::~GameCore() {}
+
+void GameCore::reset() {
+    current_turn = 0;
+    bullets.clear();
+    game_map.reset();
+}
+
+void GameCore::placeTanks(int x_a, int y_a, Direction dir_a, int x_b, int y_b, Direction dir_b, int life_points) {
+    tank_a = std::make_unique<Tank>(x_a, y_a, dir_a, life_points, 'A');
+    tank_b = std::make_unique<Tank>(x_b, y_b, dir_b, life_points, 'B');
+}
+
+void GameCore::beginTurn() {
+    current_turn++;
+    game_map.updateTurn();
+    if (observer && game_map.shouldShrink()) {
+        GameEvent event(EV_MAP_SHRINK, current_turn);
+        event.value = game_map.getCurrentSize();
+        notify(event);
+    }
+}
+
+void GameCore::applyMove(char tank_id, Move move) {
+    Tank& tank = tankById(tank_id);
+    tank.move(move);
+    if (observer) {
+        GameEvent event(EV_TANK_MOVE, current_turn);
+        event.tank_id = tank_id;
+        event.x = tank.getX();
+        event.y = tank.getY();
+        event.direction = static_cast<uint8_t>(tank.getDirection());
+        event.value = move;
+        notify(event);
+    }
+    tank.updateShootCounter();
+    if (tank.canShoot()) {
+        spawnBullet(tank);
+        tank.resetShootCounter();
+    }
+}
+
+void GameCore::finishTurn() {
+    processBulletMovement();
+    processCollisions();
+    processOutOfMapDamage();
+    endTurn();
+}
+
+void GameCore::endTurn() {
+    if (observer) notify(GameEvent(EV_TURN_END, current_turn));
+}
+
+void GameCore::processBulletMovement() {
+    for (Bullet& bullet : bullets) {
+        if (bullet.isActive()) {
+            bullet.move();
+            if (observer) {
+                GameEvent event(EV_BULLET_MOVE, current_turn);
+                event.tank_id = bullet.getOwnerId();
+                event.x = bullet.getX();
+                event.y = bullet.getY();
+                event.direction = static_cast<uint8_t>(bullet.getDirection());
+                notify(event);
+            }
+            if (bullet.isOutOfBounds(BULLET_AREA)) {
+                bullet.deactivate();
+            }
+        }
+    }
+    cleanupBullets();
+}
+
+void GameCore::processCollisions() {
+    for (Bullet& bullet : bullets) {
+        if (!bullet.isActive()) continue;
+        
+        if (bullet.checkCollisionWithTank(*tank_a)) {
+            handleBulletHit(*tank_a);
+            bullet.deactivate();
+            continue;
+        }
+
+        if (bullet.checkCollisionWithTank(*tank_b)) {
+            handleBulletHit(*tank_b);
+            bullet.deactivate();
+            continue;
+        }
+    }
+}
+
+void GameCore::processOutOfMapDamage() {
+    for (Tank* tank : {tank_a.get(), tank_b.get()}) {
+        if (game_map.shouldTakeDamageOutOfMap(*tank)) {
+            tank->takeDamage(OUT_OF_MAP_DAMAGE);
+            if (observer) {
+                GameEvent event(EV_TANK_DAMAGE, current_turn);
+                event.tank_id = tank->getTankId();
+                event.value = tank->getLifePoints();
+                event.detail = DAMAGE_OUT_OF_MAP;
+                notify(event);
+            }
+        }
+    }
+}
+
+GameResult GameCore::checkGameEnd() const {
+    bool tank_a_alive = tank_a->isAlive();
+    bool tank_b_alive = tank_b->isAlive();
+
+    if (checkTankCollision()) {
+        if (tank_a->getLifePoints() > tank_b->getLifePoints()) return TANK_A_WIN;
+        else if (tank_b->getLifePoints() > tank_a->getLifePoints()) return TANK_B_WIN;
+        else return DRAW;
+    }
+
+    if (!tank_a_alive && !tank_b_alive) return DRAW;
+    else if (!tank_a_alive) return TANK_B_WIN;
+    else if (!tank_b_alive) return TANK_A_WIN;
+    
+    return GAME_CONTINUE;
+}
+
+bool GameCore::checkTankCollision() const {
+    return tank_a->getX() == tank_b->getX() && tank_a->getY() == tank_b->getY();
+}
+
+bool GameCore::validateTankPosition(int x, int y) {
+    return x >= 0 && x < INITIAL_MAP_SIZE && y >= 0 && y < INITIAL_MAP_SIZE;
+}
+
+void GameCore::spawnBullet(Tank& tank) {
+    int bullet_x, bullet_y;
+    tank.getBulletSpawnPosition(bullet_x, bullet_y);
+    
+    bullets.emplace_back(bullet_x, bullet_y, tank.getDirection(), tank.getTankId());
+    
+    if (observer) {
+        GameEvent event(EV_TANK_SHOOT, current_turn);
+        event.tank_id = tank.getTankId();
+        event.x = bullet_x;
+        event.y = bullet_y;
+        event.direction = static_cast<uint8_t>(tank.getDirection());
+        notify(event);
+    }
+}
+
+void GameCore::handleBulletHit(Tank& tank) {
+    tank.takeDamage(BULLET_DAMAGE);
+    if (!observer) return;
+    
+    GameEvent hit_event(EV_BULLET_HIT, current_turn);
+    hit_event.tank_id = tank.getTankId();
+    hit_event.value = BULLET_DAMAGE;
+    notify(hit_event);
+    
+    GameEvent damage_event(EV_TANK_DAMAGE, current_turn);
+    damage_event.tank_id = tank.getTankId();
+    damage_event.value = tank.getLifePoints();
+    damage_event.detail = DAMAGE_BULLET_HIT;
+    notify(damage_event);
+}
+
+void GameCore::cleanupBullets() {
+    bullets.erase(
+        std::remove_if(bullets.begin(), bullets.end(),
+            [](const Bullet& bullet) {
+                return !bullet.isActive();
+            }),
+        bullets.end()
+    );
+}
+
+uint64_t GameCore::computeStateHash() const {
+    uint64_t hash = 1469598103934665603ULL;
+    auto mix = [&hash](int value) {
+        hash ^= static_cast<uint32_t>(value);
+        hash *= 1099511628211ULL;
+    };
+    
+    mix(current_turn);
+    mix(game_map.getCurrentSize());
+    mix(game_map.getTurnCount());
+    for (const Tank* tank : {tank_a.get(), tank_b.get()}) {
+        mix(tank->getX());
+        mix(tank->getY());
+        mix(tank->getDirection());
+        mix(tank->getLifePoints());
+        mix(tank->getShootCounter());
+    }
+    for (const Bullet& bullet : bullets) {
+        mix(bullet.getX());
+        mix(bullet.getY());
+        mix(bullet.getDirection());
+        mix(bullet.getOwnerId());
+        mix(bullet.isActive());
+    }
+    return hash;
+}
+
+void GameCore::captureSnapshot(GameSnapshot& snapshot) const {
+    snapshot.current_turn = current_turn;
+    snapshot.map_size = game_map.getCurrentSize();
+    snapshot.map_turn_count = game_map.getTurnCount();
+    
+    TankSnapshot* targets[2] = {&snapshot.tank_a, &snapshot.tank_b};
+    const Tank* sources[2] = {tank_a.get(), tank_b.get()};
+    for (int i = 0; i < 2; i++) {
+        targets[i]->x = sources[i]->getX();
+        targets[i]->y = sources[i]->getY();
+        targets[i]->direction = sources[i]->getDirection();
+        targets[i]->life_points = sources[i]->getLifePoints();
+        targets[i]->shoot_counter = sources[i]->getShootCounter();
+    }
+    
+    // reused snapshots get room for the worst case on first use
+    if (snapshot.bullets.capacity() < static_cast<size_t>(MAX_LIVE_BULLETS)) {
+        snapshot.bullets.reserve(MAX_LIVE_BULLETS);
+    }
+    snapshot.bullets.resize(bullets.size());
+    for (size_t i = 0; i < bullets.size(); i++) {
+        BulletSnapshot& target = snapshot.bullets[i];
+        target.x = bullets[i].getX();
+        target.y = bullets[i].getY();
+        target.direction = bullets[i].getDirection();
+        target.owner_id = bullets[i].getOwnerId();
+        target.active = bullets[i].isActive();
+    }
+}
+
+void GameCore::restoreSnapshot(const GameSnapshot& snapshot) {
+    game_map.setCurrentSize(snapshot.map_size);
+    game_map.setTurnCount(snapshot.map_turn_count);
+    current_turn = snapshot.current_turn;
+    
+    const TankSnapshot* sources[2] = {&snapshot.tank_a, &snapshot.tank_b};
+    std::unique_ptr<Tank>* targets[2] = {&tank_a, &tank_b};
+    const char ids[2] = {'A', 'B'};
+    for (int i = 0; i < 2; i++) {
+        *targets[i] = std::make_unique<Tank>(sources[i]->x, sources[i]->y, sources[i]->direction,
+                                             sources[i]->life_points, ids[i]);
+        (*targets[i])->setShootCounter(sources[i]->shoot_counter);
+    }
+    
+    bullets.clear();
+    for (const BulletSnapshot& source : snapshot.bullets) {
+        bullets.emplace_back(source.x, source.y, source.direction, source.owner_id);
+        bullets.back().setActive(source.active);
+    }
+}
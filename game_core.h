@@ -0,0 +1,80 @@
+// game_core.h
+
+#ifndef GAME_CORE_H
+#define GAME_CORE_H
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "common.h"
+#include "tank.h"
+#include "bullet.h"
+#include "game_map.h"
+#include "game_snapshot.h"
+#include "game_event.h"
+
+// The rules of a match with no I/O: board state and the steps of a turn.
+// Anything that wants to watch (event bus, logger, stats) installs itself as
+// the observer; without one no event is even built.
+//
+// A turn is beginTurn(), applyMove() for A then B, and, unless the tanks
+// collided, finishTurn(): the three process steps and endTurn().
+class GameCore {
+private:
+    std::unique_ptr<Tank> tank_a;
+    std::unique_ptr<Tank> tank_b;
+    std::vector<Bullet> bullets; // by value, capacity reserved up front
+    GameMap game_map;
+    int current_turn;
+    GameEventHandler* observer;
+
+public:
+    GameCore();
+    ~GameCore();
+
+    GameCore(const GameCore&) = delete;
+    GameCore& operator=(const GameCore&) = delete;
+
+    void setObserver(GameEventHandler* handler) { observer = handler; }
+
+    // back to turn 0 on a full map, keeping the tanks
+    void reset();
+    void placeTanks(int x_a, int y_a, Direction dir_a, int x_b, int y_b, Direction dir_b, int life_points);
+    bool hasTanks() const { return tank_a != nullptr; }
+
+    // turn steps
+    void beginTurn();
+    void applyMove(char tank_id, Move move);
+    void finishTurn();
+    void processBulletMovement();
+    void processCollisions();
+    void processOutOfMapDamage();
+    void endTurn();
+
+    // rules
+    GameResult checkGameEnd() const;
+    bool checkTankCollision() const;
+    static bool validateTankPosition(int x, int y);
+
+    // FNV-1a over everything that the next turn depends on
+    uint64_t computeStateHash() const;
+    void captureSnapshot(GameSnapshot& snapshot) const;
+    void restoreSnapshot(const GameSnapshot& snapshot);
+
+    const Tank& getTankA() const { return *tank_a; }
+    const Tank& getTankB() const { return *tank_b; }
+    const Tank& getTankById(char tank_id) const { return (tank_id == 'A') ? *tank_a : *tank_b; }
+    const Tank& getOtherTank(char tank_id) const { return (tank_id == 'A') ? *tank_b : *tank_a; }
+    const std::vector<Bullet>& getBullets() const { return bullets; }
+    const GameMap& getGameMap() const { return game_map; }
+    int getCurrentTurn() const { return current_turn; }
+
+private:
+    Tank& tankById(char tank_id) { return (tank_id == 'A') ? *tank_a : *tank_b; }
+    void spawnBullet(Tank& tank);
+    void handleBulletHit(Tank& tank);
+    void cleanupBullets();
+    void notify(const GameEvent& event) const { observer->handleEvent(event); }
+};
+
+#endif // GAME_CORE_H
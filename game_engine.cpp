@@ -1,40 +1,82 @@
 // game_engine.cpp
 
 #include "game_engine.h"
+#include "endgame_table.h"
 #include <iostream>
 #include <algorithm>
+#include <random>
+#include <thread>
+#include <chrono>
+#include <ctime>
 
 GameEngine::GameEngine(GameMode mode, int life_points, const std::string& log_file)
-    : current_mode(mode), initial_life_points(life_points), 
-      current_turn(0), game_result(GAME_CONTINUE), 
-      game_running(false), current_player('A') {
+    : ai_level(2), ai_deadline_ms(0), current_mode(mode), initial_life_points(life_points), 
+      game_result(GAME_CONTINUE), 
+      game_running(false), current_player('A'),
+      replay_pace_ms(-1), replay_seek_turn(0), headless(false), replay_diverged(false),
+      last_move_a(M_Forward), last_move_b(M_Forward), collect_stats(false), render_fps(0),
+      use_raw_input(false), move_timeout_ms(0), ponder_enabled(true) {
     
-    initializeComponents();
+    std::random_device rd;
+    rng_seed = (static_cast<uint64_t>(rd()) << 32) | rd();
     logger = std::make_unique<Logger>(log_file);
     ui_manager = std::make_unique<UIManager>(true);
 }
 
-GameEngine::~GameEngine() {}
+GameEngine::~GameEngine() {
+    stopEventConsumers();
+}
 
 bool GameEngine::initializeGame() {
     try {
-        game_map = std::make_unique<GameMap>(INITIAL_MAP_SIZE);
+        startEventConsumers();
+        core.reset();
         
-        if (!setupTanks()) return false;
+        if (resume_checkpoint) {
+            if (!restoreCheckpoint(*resume_checkpoint)) return false;
+        } else {
+            if (!setupTanks()) return false;
+            if (!setupAI()) return false;
+        }
         
-        if (!setupAI()) return false;
+        if (!record_filename.empty()) {
+            ReplayHeader header;
+            header.mode = current_mode;
+            header.initial_life_points = initial_life_points;
+            const Tank& tank_a = core.getTankA();
+            const Tank& tank_b = core.getTankB();
+            header.tank_a_x = tank_a.getX();
+            header.tank_a_y = tank_a.getY();
+            header.tank_a_dir = tank_a.getDirection();
+            header.tank_b_x = tank_b.getX();
+            header.tank_b_y = tank_b.getY();
+            header.tank_b_dir = tank_b.getDirection();
+            header.rng_seed = rng_seed;
+            
+            replay_recorder = std::make_unique<ReplayRecorder>();
+            if (!replay_recorder->open(record_filename, header)) {
+                ui_manager->printError("Cannot open replay file: " + record_filename);
+                return false;
+            }
+            
+            GameSnapshot snapshot;
+            captureSnapshot(snapshot);
+            replay_recorder->recordKeyframe(snapshot);
+        }
         
-        logger->logGameStart(
-            (current_mode == PVP) ? "PVP" : 
-            (current_mode == PVE) ? "PVE" : "DEMO", 
-            initial_life_points
-        );
+        GameEvent event(EV_GAME_START, core.getCurrentTurn());
+        event.detail = static_cast<uint8_t>(current_mode);
+        event.value = initial_life_points;
+        publishEvent(event);
         
-        game_running = true;
+        game_running = (game_result == GAME_CONTINUE);
+        updateCheckpoint();
+        publishSpectatorTurn();
+        publishSharedState();
         return true;
         
     } catch (const std::exception& e) {
-        logger->logError("Failed to initialize game: " + std::string(e.what()));
+        publishError("Failed to initialize game: " + std::string(e.what()));
         return false;
     }
 }
@@ -43,7 +85,25 @@ bool GameEngine::setupTanks() {
     int x_a, y_a, x_b, y_b;
     Direction dir_a, dir_b;
     
-    if (current_mode == PVP || current_mode == PVE) {
+    if (replay_reader) {
+        const ReplayHeader& header = replay_reader->getHeader();
+        x_a = header.tank_a_x; y_a = header.tank_a_y; dir_a = header.tank_a_dir;
+        x_b = header.tank_b_x; y_b = header.tank_b_y; dir_b = header.tank_b_dir;
+    } else if (input_script && (current_mode == PVP || current_mode == PVE)) {
+        const ScriptSetup& setup_a = input_script->getSetup('A');
+        const ScriptSetup& setup_b = input_script->getSetup('B');
+        if (!setup_a.present || (current_mode == PVP && !setup_b.present)) {
+            ui_manager->printError("Input script has no setup for tank " +
+                                   std::string(setup_a.present ? "B" : "A"));
+            return false;
+        }
+        x_a = setup_a.x; y_a = setup_a.y; dir_a = setup_a.direction;
+        if (current_mode == PVP) {
+            x_b = setup_b.x; y_b = setup_b.y; dir_b = setup_b.direction;
+        } else {
+            x_b = INITIAL_MAP_SIZE - 1; y_b = INITIAL_MAP_SIZE - 1; dir_b = D_Left;
+        }
+    } else if (current_mode == PVP || current_mode == PVE) {
         ui_manager->printInitialSetup(current_mode);
         
         if (!getInitialTankSetup('A', x_a, y_a, dir_a)) {
@@ -58,23 +118,22 @@ bool GameEngine::setupTanks() {
             }
         } else {
             // AI sets automatically
-            x_b = 19; y_b = 19; dir_b = D_Left;
+            x_b = INITIAL_MAP_SIZE - 1; y_b = INITIAL_MAP_SIZE - 1; dir_b = D_Left;
         }
     } else {
         // AI sets automatically
         x_a = 0; y_a = 0; dir_a = D_Right;
-        x_b = 19; y_b = 19; dir_b = D_Left;
+        x_b = INITIAL_MAP_SIZE - 1; y_b = INITIAL_MAP_SIZE - 1; dir_b = D_Left;
     }
     
-    tank_a = std::make_unique<Tank>(x_a, y_a, dir_a, initial_life_points, 'A');
-    tank_b = std::make_unique<Tank>(x_b, y_b, dir_b, initial_life_points, 'B');
+    core.placeTanks(x_a, y_a, dir_a, x_b, y_b, dir_b, initial_life_points);
     
-    if (!validateTankPosition(x_a, y_a) || !validateTankPosition(x_b, y_b)) {
+    if (!GameCore::validateTankPosition(x_a, y_a) || !GameCore::validateTankPosition(x_b, y_b)) {
         ui_manager->printError("Invalid tank positions");
         return false;
     }
     
-    if (areTanksColliding()) {
+    if (core.checkTankCollision()) {
         ui_manager->printError("Tanks cannot start at the same position");
         return false;
     }
@@ -83,308 +142,519 @@ bool GameEngine::setupTanks() {
 }
 
 bool GameEngine::setupAI() {
+    if (replay_reader) return true; // moves come from the replay file
+    
     if (current_mode == PVE) {
-        ai_player_b = std::make_unique<AIPlayer>('B', 2); 
+        ai_player_b = std::make_unique<AIPlayer>('B', ai_level, rng_seed); 
     } else if (current_mode == DEMO) {
-        ai_player_a = std::make_unique<AIPlayer>('A', 2);
-        ai_player_b = std::make_unique<AIPlayer>('B', 2);
+        ai_player_a = std::make_unique<AIPlayer>('A', ai_level, rng_seed);
+        ai_player_b = std::make_unique<AIPlayer>('B', ai_level, rng_seed);
+    }
+    std::unique_ptr<AIPlayer>* players[2] = {&ai_player_a, &ai_player_b};
+    for (std::unique_ptr<AIPlayer>* player : players) {
+        if (!*player) continue;
+        (*player)->setSearchBudget(ai_budget);
+        (*player)->setWeights(ai_weights);
+        (*player)->setEndgameTable(endgame_table);
     }
     return true;
 }
 
-void GameEngine::runGame() {
+bool GameEngine::runGame() {
     if (!initializeGame()) {
         ui_manager->printError("Failed to initialize game");
-        return;
+        return false;
     }
     
-    ui_manager->printWelcomeMessage(current_mode);
-    ui_manager->printGameRules();
+    if (!headless) {
+        ui_manager->printWelcomeMessage(current_mode);
+        ui_manager->printGameRules();
+    }
+    
+    if (replay_reader && replay_seek_turn > 0) {
+        if (!seekReplay(replay_seek_turn)) {
+            ui_manager->printError("Cannot seek replay to turn " + std::to_string(replay_seek_turn));
+            return false;
+        }
+        if (tui_renderer) {
+            displayGameState();
+        } else {
+            ui_manager->printGameMap(core);
+            ui_manager->printGameStatus(core);
+        }
+    }
+    
+    if (resume_checkpoint && !headless) {
+        ui_manager->printMessage("Resumed at turn " + std::to_string(core.getCurrentTurn()));
+        ui_manager->printGameMap(core);
+    }
+    
+    bool human_input = current_mode != DEMO && !replay_reader && !input_script;
+    if (use_raw_input && human_input) {
+        raw_input = std::make_unique<RawInput>(move_timeout_ms);
+        if (raw_input->enable()) {
+            ui_manager->printMessage("Keys: tank A W/A/D, tank B Up/Left/Right arrows");
+        } else {
+            ui_manager->printWarning("Raw input needs a terminal, reading moves line by line");
+            raw_input.reset();
+        }
+    }
+    
+    // the search levels need the whole game, not the AIState the ponderer guesses from
+    if (ponder_enabled && current_mode == PVE && ai_player_b && !input_script &&
+        ai_player_b->getDifficultyLevel() <= 3) {
+        ponderer = std::make_unique<AIPonderer>();
+    }
+    
+    // a prompt must follow the board it asks about, so players get it drawn every turn
+    if (render_fps > 0 && !headless && human_input) {
+        ui_manager->printWarning("--fps only paces DEMO games and replays, drawing every turn");
+    } else if (render_fps > 0 && !headless) {
+        render_thread = std::make_unique<RenderThread>(*ui_manager, tui_renderer.get(), render_fps);
+        render_thread->start();
+    }
     
     while (game_running && gameLoop()) {}
     
     endGame();
+    return true;
 }
 
 // execute one full round
 bool GameEngine::gameLoop() {
-    current_turn++;
-    game_map->updateTurn();
-    if (game_map->shouldShrink()) {
-        logger->logMapShrink(game_map->getCurrentSize());
+    if (replay_reader && core.getCurrentTurn() >= replay_reader->getTurnCount()) {
+        game_running = false; // replay ran out of recorded turns
+        return false;
     }
-    ui_manager->printTurnInfo(current_turn, 'A'); 
-    processTankTurn(getTankA(), 'A');
-    ui_manager->printTurnInfo(current_turn, 'B'); 
-    processTankTurn(getTankB(), 'B');
+    if (input_script && current_mode != DEMO && !input_script->hasMoreMoves()) {
+        game_running = false;
+        return false;
+    }
+    
+    if (!profiler) return playTurn();
+    
+    profiler->beginTurn();
+    bool more = playTurn();
+    profiler->endTurn();
+    return more;
+}
+
+bool GameEngine::playTurn() {
+    core.beginTurn();
+    bool show_turn_info = !headless && !tui_renderer && !render_thread;
+    if (show_turn_info) ui_manager->printTurnInfo(core.getCurrentTurn(), 'A'); 
+    if (profiler) profiler->lap(PHASE_RENDER);
+    // the copies decide on the guessed AIState, which the endgame table cannot
+    // probe, so once the table may apply the AI waits for the real move
+    bool table_applies = endgame_table && core.getGameMap().getCurrentSize() <= ENDGAME_MAP_SIZE;
+    if (ponderer && !table_applies) ponderer->start(*ai_player_b, ai_player_b->getGameState(core), core.getTankA());
+    processTankTurn('A');
+    if (show_turn_info) ui_manager->printTurnInfo(core.getCurrentTurn(), 'B'); 
+    if (profiler) profiler->lap(PHASE_RENDER);
+    processTankTurn('B');
     
 
-    if (checkTankCollision()) {
-        game_result = checkGameEnd(); 
+    if (core.checkTankCollision()) {
+        game_result = core.checkGameEnd(); 
         game_running = false;
+        syncReplayTurn();
+        publishSpectatorTurn();
+        publishSharedState();
+        if (profiler) profiler->lap(PHASE_LOGGING);
         return false;
     }
 
-    processBulletMovement();
-    processCollisions();
-    processOutOfMapDamage();
-    updateGameState();
+    if (profiler) {
+        core.processBulletMovement();
+        profiler->lap(PHASE_BULLETS);
+        core.processCollisions();
+        profiler->lap(PHASE_COLLISIONS);
+        core.processOutOfMapDamage();
+        profiler->lap(PHASE_MAP_DAMAGE);
+        core.endTurn();
+    } else {
+        core.finishTurn();
+    }
+    
+    if (!syncReplayTurn()) {
+        game_running = false;
+        return false;
+    }
+    publishSpectatorTurn();
+    publishSharedState();
+    if (profiler) profiler->lap(PHASE_LOGGING);
+    
     displayGameState();
+    if (raw_input) raw_input->noteFrameShown();
+    if (profiler) profiler->lap(PHASE_RENDER);
+    if (replay_reader && replay_pace_ms > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(replay_pace_ms));
+        if (profiler) profiler->skip();
+    }
     
-    game_result = checkGameEnd();
+    game_result = core.checkGameEnd();
     if (game_result != GAME_CONTINUE) {
         game_running = false;
         return false;
     }
+    
+    updateCheckpoint();
+    if (profiler) profiler->lap(PHASE_LOGGING);
     return true;
 }
 
 bool GameEngine::processTurn() {
     try {
-        Tank& current_tank = getTankById(current_player);
-        if (!processTankTurn(current_tank, current_player)) {
+        if (!processTankTurn(current_player)) {
             return false;
         }
         
-        processBulletMovement();
-        processCollisions();
-        processOutOfMapDamage();
-        updateGameState();
+        core.finishTurn();
         return true;
     } catch (const std::exception& e) {
-        logger->logError("Error processing turn: " + std::string(e.what()));
+        publishError("Error processing turn: " + std::string(e.what()));
         return false;
     }
 }
 
-bool GameEngine::processTankTurn(Tank& tank, char tank_id) {
+bool GameEngine::processTankTurn(char tank_id) {
     Move move = getPlayerMove(tank_id);
-    tank.move(move);
-    logger->logTankMove(tank_id, tank.getX(), tank.getY(), 
-                       ui_manager->directionToString(tank.getDirection()));
-    tank.updateShootCounter();
-    if (tank.canShoot()) {
-        spawnBullet(tank);
-        tank.resetShootCounter();
-    }
+    if (profiler) profiler->lap(PHASE_DECIDE);
+    if (tank_id == 'A') last_move_a = move;
+    else last_move_b = move;
+    core.applyMove(tank_id, move);
+    if (profiler) profiler->lap(PHASE_MOVE);
     return true;
 }
 
-void GameEngine::processBulletMovement() {
-    for (auto& bullet : bullets) {
-        if (bullet->isActive()) {
-            // int old_x = bullet->getX();
-            // int old_y = bullet->getY();
-            bullet->move();
-            logger->logBulletMove(bullet->getX(), bullet->getY(),
-                                ui_manager->directionToString(bullet->getDirection()));
-            if (bullet->isOutOfBounds(INITIAL_MAP_SIZE + 20)) {
-                bullet->deactivate();
-            }
-        }
+Move GameEngine::getPlayerMove(char tank_id) {
+    if (replay_reader) {
+        Move move_a, move_b;
+        uint16_t state_hash;
+        if (!replay_reader->getTurn(core.getCurrentTurn(), move_a, move_b, state_hash)) return M_Forward;
+        return (tank_id == 'A') ? move_a : move_b;
+    }
+    
+    if (input_script && (current_mode == PVP || tank_id == 'A')) {
+        Move move;
+        if (input_script->nextMove(move)) return move;
+        publishError("Input script has no valid move for tank " + std::string(1, tank_id) +
+                     " at turn " + std::to_string(core.getCurrentTurn()));
+        game_running = false;
+        return M_Forward;
+    }
+    if (raw_input && (current_mode == PVP || tank_id == 'A')) return raw_input->waitForMove(tank_id);
+    if (current_mode == PVP) return ui_manager->getPlayerInput(tank_id);
+    else if (current_mode == PVE) {
+        if (tank_id == 'A') return ui_manager->getPlayerInput(tank_id);
+        else return getAIMove(tank_id);
     }
-    cleanupBullets();
+    else return getAIMove(tank_id); // DEMO
 }
 
-bool GameEngine::checkBulletPathCollision(const Bullet& bullet, const Tank& tank) const {
-    int tank_x = tank.getX();
-    int tank_y = tank.getY();
-    int bullet_x = bullet.getX();
-    int bullet_y = bullet.getY();
-
-    int next_bullet_x, next_bullet_y;
-    bullet.getNextPosition(next_bullet_x, next_bullet_y);
-
-    // check if tank is on the straight line of bullet movement
-    bool same_x = (bullet_x == tank_x) && (next_bullet_x == tank_x);
-    bool same_y = (bullet_y == tank_y) && (next_bullet_y == tank_y);
-    if (!same_x && !same_y) return false;
+Move GameEngine::getAIMove(char tank_id) {
+    Move reply;
+    if (tank_id == 'B' && ponderer && ponderer->take(last_move_a, *ai_player_b, reply)) return reply;
+    AIPlayer* ai = (tank_id == 'A') ? ai_player_a.get() : ai_player_b.get();
+    if (!ai) return M_Forward; // default
+    if (ai_deadline_ms > 0) return ai->makeDecision(core, DecisionClock::now() + std::chrono::milliseconds(ai_deadline_ms));
+    return ai->makeDecision(core);
+}
 
-    // check if tank is between current and next bullet position
-    if (same_x) {  // y changes
-        int min_y = std::min(bullet_y, next_bullet_y);
-        int max_y = std::max(bullet_y, next_bullet_y);
-        return (tank_y >= min_y && tank_y <= max_y);
-    } else {  // x changes
-        int min_x = std::min(bullet_x, next_bullet_x);
-        int max_x = std::max(bullet_x, next_bullet_x);
-        return (tank_x >= min_x && tank_x <= max_x);
-    }
+bool GameEngine::getInitialTankSetup(char tank_id, int& x, int& y, Direction& dir) {
+    return ui_manager->getTankInitialPosition(tank_id, x, y, dir);
 }
 
-void GameEngine::processCollisions() {
-    for (auto& bullet : bullets) {
-        if (!bullet->isActive()) continue;
-        
-        if (bullet->checkCollisionWithTank(*tank_a)) {
-            handleBulletHit(*bullet, *tank_a);
-            bullet->deactivate();
-            continue;
-        }
+void GameEngine::resetGame() {
+    game_result = GAME_CONTINUE;
+    game_running = false;
+    current_player = 'A';
+    core.reset();
+}
 
-        if (bullet->checkCollisionWithTank(*tank_b)) {
-            handleBulletHit(*bullet, *tank_b);
-            bullet->deactivate();
-            continue;
+void GameEngine::endGame() {
+    if (replay_recorder) replay_recorder->finish(game_result);
+    if (render_thread) render_thread->stop();
+    if (tui_renderer) tui_renderer->finish();
+    if (raw_input) raw_input->restore();
+    if (ponderer) ponderer->cancel();
+    
+    if (!headless || replay_reader) ui_manager->printGameResult(game_result);
+    if (input_script && game_result == GAME_CONTINUE && !headless) {
+        ui_manager->printMessage("Input script ended at turn " + std::to_string(core.getCurrentTurn()));
+    }
+    if (replay_reader) {
+        if (replay_diverged) {
+            ui_manager->printError("Replay diverged at turn " + std::to_string(core.getCurrentTurn()));
+        } else {
+            ui_manager->printMessage("Replay verified: " + std::to_string(core.getCurrentTurn()) + " of " +
+                                     std::to_string(replay_reader->getTurnCount()) + " turns");
         }
     }
-}
-
-void GameEngine::processOutOfMapDamage() {
-    if (game_map->shouldTakeDamageOutOfMap(*tank_a)) {
-        tank_a->takeDamage(OUT_OF_MAP_DAMAGE);
-        logger->logTankDamage('A', tank_a->getLifePoints(), "out of map");
+    
+    if (spectator) spectator->writeEnd(core.getCurrentTurn(), game_result);
+    if (shared_state) {
+        publishSharedState();
+        shared_state->release();
     }
     
-    if (game_map->shouldTakeDamageOutOfMap(*tank_b)) {
-        tank_b->takeDamage(OUT_OF_MAP_DAMAGE);
-        logger->logTankDamage('B', tank_b->getLifePoints(), "out of map");
+    GameEvent event(EV_GAME_END, core.getCurrentTurn());
+    event.detail = static_cast<uint8_t>(game_result);
+    publishEvent(event);
+    stopEventConsumers();
+    
+    if (stats_collector && !headless) {
+        ui_manager->printMessage(stats_collector->getSummary());
+    }
+    if (raw_input) ui_manager->printMessage(raw_input->getSummary());
+    if (ponderer && collect_stats) ui_manager->printMessage(ponderer->getSummary());
+    if ((collect_stats || profiler) && !headless) {
+        if (ai_player_a) ui_manager->printMessage(ai_player_a->getDecisionStats().getSummary("AI A"));
+        if (ai_player_b) ui_manager->printMessage(ai_player_b->getDecisionStats().getSummary("AI B"));
     }
+    if (profiler && (!headless || replay_reader)) ui_manager->printMessage(profiler->getSummary());
+}
+
+char GameEngine::getOtherTankId(char tank_id) const {
+    return (tank_id == 'A') ? 'B' : 'A';
 }
 
-GameResult GameEngine::checkGameEnd() {
-    bool tank_a_alive = tank_a->isAlive();
-    bool tank_b_alive = tank_b->isAlive();
+void GameEngine::switchPlayer() {
+    current_player = (current_player == 'A') ? 'B' : 'A';
+}
 
-    if (checkTankCollision()) {
-        if (tank_a->getLifePoints() > tank_b->getLifePoints()) return TANK_A_WIN;
-        else if (tank_b->getLifePoints() > tank_a->getLifePoints()) return TANK_B_WIN;
-        else return DRAW;
+void GameEngine::displayGameState() {
+    if (render_thread) {
+        captureSnapshot(observer_snapshot);
+        render_thread->publish(observer_snapshot);
+    } else if (tui_renderer && !headless) {
+        captureSnapshot(observer_snapshot);
+        tui_renderer->render(observer_snapshot);
+    } else if (ui_manager && !headless) {
+        ui_manager->printGameMap(core);
+        if (core.getCurrentTurn() % 5 == 0) { // show detailed status every five rounds
+            ui_manager->printGameStatus(core);
+        }
     }
+}
 
-    if (!tank_a_alive && !tank_b_alive) return DRAW;
-    else if (!tank_a_alive) return TANK_B_WIN;
-    else if (!tank_b_alive) return TANK_A_WIN;
-    
-    return GAME_CONTINUE;
+void GameEngine::setHeadless(bool enable) {
+    headless = enable;
+    if (headless) logger->enableLogging(false);
 }
 
-bool GameEngine::checkTankCollision() {
-    return tank_a->getX() == tank_b->getX() && tank_a->getY() == tank_b->getY();
+void GameEngine::setReplay(std::unique_ptr<ReplayReader> reader, int pace_ms) {
+    replay_reader = std::move(reader);
+    replay_pace_ms = pace_ms;
+    rng_seed = replay_reader->getHeader().rng_seed;
+    setHeadless(pace_ms < 0);
 }
 
-void GameEngine::handleBulletHit(Bullet& bullet, Tank& tank) {
-    (void)bullet;
-    tank.takeDamage(BULLET_DAMAGE);
-    logger->logBulletHit(tank.getTankId(), BULLET_DAMAGE);
-    logger->logTankDamage(tank.getTankId(), tank.getLifePoints(), "bullet hit");
+// record the finished turn, or check it against the replay being played back
+bool GameEngine::syncReplayTurn() {
+    if (replay_recorder) {
+        replay_recorder->recordTurn(last_move_a, last_move_b, foldStateHash(computeStateHash()));
+        if (core.getCurrentTurn() % REPLAY_KEYFRAME_INTERVAL == 0) {
+            GameSnapshot snapshot;
+            captureSnapshot(snapshot);
+            replay_recorder->recordKeyframe(snapshot);
+        }
+    }
+    
+    if (replay_reader) {
+        Move move_a, move_b;
+        uint16_t expected_hash;
+        replay_reader->getTurn(core.getCurrentTurn(), move_a, move_b, expected_hash);
+        if (foldStateHash(computeStateHash()) != expected_hash) {
+            replay_diverged = true;
+            return false;
+        }
+    }
+    return true;
 }
 
-void GameEngine::spawnBullet(Tank& tank) {
-    int bullet_x, bullet_y;
-    tank.getBulletSpawnPosition(bullet_x, bullet_y);
+// restore the nearest keyframe and re-simulate only the turns after it
+bool GameEngine::seekReplay(int turn) {
+    if (!replay_reader || turn < 0 || turn > replay_reader->getTurnCount()) return false;
+    if (!core.hasTanks() && !initializeGame()) return false;
     
-    auto new_bullet = std::make_unique<Bullet>(
-        bullet_x, bullet_y, tank.getDirection(), tank.getTankId()
-    );
+    GameSnapshot snapshot;
+    if (replay_reader->findKeyframe(turn, snapshot)) {
+        restoreSnapshot(snapshot);
+    } else {
+        // no index: start over from the recorded setup
+        resetGame();
+        if (!setupTanks()) return false;
+        game_running = true;
+    }
     
-    bullets.push_back(std::move(new_bullet));
+    bool was_headless = headless;
+    headless = true;
+    while (game_running && core.getCurrentTurn() < turn && gameLoop()) {}
+    headless = was_headless;
     
-    logger->logTankShoot(tank.getTankId(), bullet_x, bullet_y);
+    return core.getCurrentTurn() == turn && !replay_diverged;
 }
 
-Move GameEngine::getPlayerMove(char tank_id) {
-    if (current_mode == PVP) return ui_manager->getPlayerInput(tank_id);
-    else if (current_mode == PVE) {
-        if (tank_id == 'A') return ui_manager->getPlayerInput(tank_id);
-        else return getAIMove(tank_id);
-    }
-    else return getAIMove(tank_id); // DEMO
+void GameEngine::restoreSnapshot(const GameSnapshot& snapshot) {
+    core.restoreSnapshot(snapshot);
+    game_result = (core.getCurrentTurn() > 0) ? core.checkGameEnd() : GAME_CONTINUE;
+    game_running = (game_result == GAME_CONTINUE);
 }
 
-Move GameEngine::getAIMove(char tank_id) {
-    if (tank_id == 'A' && ai_player_a) return ai_player_a->makeDecision(*this);
-    else if (tank_id == 'B' && ai_player_b) return ai_player_b->makeDecision(*this);
-    return M_Forward; // default
+void GameEngine::setCheckpoint(const std::string& filename, int interval_turns) {
+    checkpoint_manager = std::make_unique<CheckpointManager>(filename, interval_turns);
+    checkpoint_manager->installSignalHandler();
 }
 
-bool GameEngine::getInitialTankSetup(char tank_id, int& x, int& y, Direction& dir) {
-    return ui_manager->getTankInitialPosition(tank_id, x, y, dir);
+void GameEngine::setResume(std::unique_ptr<MatchCheckpoint> checkpoint) {
+    resume_checkpoint = std::move(checkpoint);
+    rng_seed = resume_checkpoint->rng_seed;
 }
 
-void GameEngine::updateGameState() {
-    logGameState();
-}
-
-void GameEngine::resetGame() {
-    current_turn = 0;
-    game_result = GAME_CONTINUE;
-    game_running = false;
-    current_player = 'A';
+void GameEngine::buildCheckpoint(MatchCheckpoint& checkpoint) const {
+    checkpoint.mode = current_mode;
+    checkpoint.initial_life_points = initial_life_points;
+    checkpoint.rng_seed = rng_seed;
+    captureSnapshot(checkpoint.snapshot);
     
-    bullets.clear();
-    game_map->reset();
+    AICheckpoint* targets[2] = {&checkpoint.ai_a, &checkpoint.ai_b};
+    const AIPlayer* sources[2] = {ai_player_a.get(), ai_player_b.get()};
+    for (int i = 0; i < 2; i++) {
+        targets[i]->present = (sources[i] != nullptr);
+        if (!sources[i]) continue;
+        targets[i]->difficulty_level = sources[i]->getDifficultyLevel();
+        targets[i]->edge_linger_turns = sources[i]->getEdgeLingerTurns();
+        targets[i]->random_draws = sources[i]->getRandomDraws();
+        targets[i]->move_history = sources[i]->getMoveHistory();
+    }
 }
 
-void GameEngine::endGame() {
-    ui_manager->printGameResult(game_result);
+bool GameEngine::restoreCheckpoint(const MatchCheckpoint& checkpoint) {
+    restoreSnapshot(checkpoint.snapshot);
     
-    std::string result_str;
-    switch (game_result) {
-        case TANK_A_WIN: result_str = "Tank A Wins"; break;
-        case TANK_B_WIN: result_str = "Tank B Wins"; break;
-        case DRAW: result_str = "Draw"; break;
-        default: result_str = "Game ended unexpectedly"; break;
+    const AICheckpoint* sources[2] = {&checkpoint.ai_a, &checkpoint.ai_b};
+    std::unique_ptr<AIPlayer>* targets[2] = {&ai_player_a, &ai_player_b};
+    const char ids[2] = {'A', 'B'};
+    for (int i = 0; i < 2; i++) {
+        targets[i]->reset();
+        if (!sources[i]->present) continue;
+        *targets[i] = std::make_unique<AIPlayer>(ids[i], sources[i]->difficulty_level, rng_seed);
+        (*targets[i])->setEdgeLingerTurns(sources[i]->edge_linger_turns);
+        (*targets[i])->setMoveHistory(sources[i]->move_history);
+        (*targets[i])->restoreRandomState(sources[i]->random_draws);
+        (*targets[i])->setSearchBudget(ai_budget);
+        (*targets[i])->setWeights(ai_weights);
+        (*targets[i])->setEndgameTable(endgame_table);
     }
-    
-    logger->logGameResult(result_str);
-}
-
-Tank& GameEngine::getTankById(char tank_id) {
-    return (tank_id == 'A') ? *tank_a : *tank_b;
-}
-
-const Tank& GameEngine::getTankById(char tank_id) const {
-    return (tank_id == 'A') ? *tank_a : *tank_b;
+    return true;
 }
 
-Tank& GameEngine::getOtherTank(char tank_id) {
-    return (tank_id == 'A') ? *tank_b : *tank_a;
+// write every K turns, and keep the latest turn staged for SIGTERM
+void GameEngine::updateCheckpoint() {
+    if (!checkpoint_manager) return;
+    
+    buildCheckpoint(checkpoint_state);
+    if (checkpoint_manager->isDue(core.getCurrentTurn()) && !checkpoint_manager->write(checkpoint_state)) {
+        publishError("Failed to write checkpoint " + checkpoint_manager->getFilename());
+    }
+    checkpoint_manager->stage(checkpoint_state);
 }
 
-const Tank& GameEngine::getOtherTank(char tank_id) const {
-    return (tank_id == 'A') ? *tank_b : *tank_a;
+void GameEngine::startEventConsumers() {
+    if (event_bus) return;
+    
+    bool want_logger = logger->isLoggingEnabled();
+    if (!want_logger && !collect_stats) return; // nobody listens: the core builds no events
+    
+    event_bus = std::make_unique<EventBus>();
+    if (want_logger) {
+        subscribers.push_back(std::make_unique<EventSubscriber>("logger", *event_bus, *logger));
+    }
+    if (collect_stats) {
+        stats_collector = std::make_unique<StatsCollector>();
+        subscribers.push_back(std::make_unique<EventSubscriber>("stats", *event_bus, *stats_collector));
+    }
+    for (auto& subscriber : subscribers) subscriber->start();
+    core.setObserver(event_bus.get());
 }
 
-char GameEngine::getOtherTankId(char tank_id) const {
-    return (tank_id == 'A') ? 'B' : 'A';
+// drain and join every consumer, then report the ones that fell behind
+void GameEngine::stopEventConsumers() {
+    if (!event_bus) return;
+    
+    core.setObserver(nullptr);
+    event_bus->close();
+    for (auto& subscriber : subscribers) {
+        subscriber->join();
+        if (subscriber->getDroppedEvents() > 0 && ui_manager) {
+            ui_manager->printWarning("Event consumer '" + subscriber->getName() + "' fell behind, " +
+                                     std::to_string(subscriber->getDroppedEvents()) + " events dropped");
+        }
+    }
+    subscribers.clear();
+    event_bus.reset();
 }
 
-void GameEngine::switchPlayer() {
-    current_player = (current_player == 'A') ? 'B' : 'A';
+void GameEngine::publishError(const std::string& message) {
+    GameEvent event(EV_ERROR, core.getCurrentTurn());
+    event.setText(message.c_str());
+    publishEvent(event);
 }
 
-void GameEngine::initializeComponents() {
-    bullets.clear();
+bool GameEngine::setSpectate(const std::string& target) {
+    spectator = std::make_unique<SpectatorStream>();
+    if (!spectator->open(target)) {
+        spectator.reset();
+        return false;
+    }
+    return true;
 }
 
-void GameEngine::cleanupBullets() {
-    bullets.erase(
-        std::remove_if(bullets.begin(), bullets.end(),
-            [](const std::unique_ptr<Bullet>& bullet) {
-                return !bullet->isActive();
-            }),
-        bullets.end()
-    );
+bool GameEngine::setSharedState(const std::string& segment_name) {
+    shared_state = std::make_unique<SharedStatePublisher>();
+    if (!shared_state->open(segment_name)) {
+        shared_state.reset();
+        return false;
+    }
+    return true;
 }
 
-bool GameEngine::validateTankPosition(int x, int y) const {
-    return x >= 0 && x < INITIAL_MAP_SIZE && y >= 0 && y < INITIAL_MAP_SIZE;
+void GameEngine::publishSharedState() {
+    if (!shared_state) return;
+    
+    MatchStatus& status = shared_status;
+    status.pid = shared_state->getOwnerPid();
+    status.state = game_running ? MATCH_RUNNING : MATCH_FINISHED;
+    status.mode = current_mode;
+    status.result = game_result;
+    status.turn = core.getCurrentTurn();
+    status.map_size = core.getGameMap().getCurrentSize();
+    status.bullet_count = static_cast<int32_t>(core.getBullets().size());
+    const Tank* tanks[2] = {&core.getTankA(), &core.getTankB()};
+    for (int i = 0; i < 2; i++) {
+        status.tank_x[i] = tanks[i]->getX();
+        status.tank_y[i] = tanks[i]->getY();
+        status.tank_direction[i] = tanks[i]->getDirection();
+        status.tank_life[i] = tanks[i]->getLifePoints();
+    }
+    status.updated_at = static_cast<uint32_t>(std::time(nullptr));
+    shared_state->publish(status);
 }
 
-bool GameEngine::areTanksColliding() const {
-    return tank_a->getX() == tank_b->getX() && tank_a->getY() == tank_b->getY();
+void GameEngine::setProfile(bool enable) {
+    if (enable) profiler = std::make_unique<TurnProfiler>();
+    else profiler.reset();
 }
 
-void GameEngine::logGameState() const {
-    logger->logTurn(current_turn);
+void GameEngine::setTui(bool enable) {
+    if (enable) tui_renderer = std::make_unique<TuiRenderer>(*ui_manager);
+    else tui_renderer.reset();
 }
 
-void GameEngine::displayGameState() const {
-    if (ui_manager) {
-        ui_manager->printGameMap(*this);
-        if (current_turn % 5 == 0) { // show detailed status every five rounds
-            ui_manager->printGameStatus(*this);
-        }
-    }
+void GameEngine::publishSpectatorTurn() {
+    if (!spectator) return;
+    
+    captureSnapshot(observer_snapshot);
+    spectator->writeTurn(observer_snapshot);
 }
\ No newline at end of file
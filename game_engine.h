@@ -5,35 +5,88 @@
 
 #include <vector>
 #include <memory>
+#include <cstdint>
 #include "common.h"
-#include "tank.h"
-#include "bullet.h"
-#include "game_map.h"
+#include "game_core.h"
 #include "logger.h"
 #include "ui_manager.h"
 #include "ai_player.h"
+#include "replay.h"
+#include "game_snapshot.h"
+#include "checkpoint.h"
+#include "event_bus.h"
+#include "stats_collector.h"
+#include "spectator_stream.h"
+#include "tui_renderer.h"
+#include "render_thread.h"
+#include "raw_input.h"
+#include "ai_ponderer.h"
+#include "shared_state.h"
+#include "input_script.h"
+#include "turn_profiler.h"
 
+// Front end around a GameCore: where moves come from (keyboard, AI, replay,
+// script), what watches the match (renderers, logs, recorders) and when it ends.
 class GameEngine {
 private:
-    // object
-    std::unique_ptr<Tank> tank_a;
-    std::unique_ptr<Tank> tank_b;
-    std::vector<std::unique_ptr<Bullet>> bullets;
-    std::unique_ptr<GameMap> game_map;
+    GameCore core; // tanks, bullets, map and the turn rules
     
     // manage
     std::unique_ptr<Logger> logger;
     std::unique_ptr<UIManager> ui_manager;
     std::unique_ptr<AIPlayer> ai_player_a;
     std::unique_ptr<AIPlayer> ai_player_b;
+    int ai_level;
+    int ai_deadline_ms; // 0: the AI takes as long as its budget says
+    SearchBudget ai_budget;
+    AIWeights ai_weights;
+    std::shared_ptr<const EndgameTable> endgame_table; // shared by both AIs and every game of a batch
+    std::unique_ptr<AIPonderer> ponderer; // PVE: B thinks while A's player does
+    std::unique_ptr<ReplayRecorder> replay_recorder;
+    std::unique_ptr<ReplayReader> replay_reader;
+    std::unique_ptr<CheckpointManager> checkpoint_manager;
+    std::unique_ptr<MatchCheckpoint> resume_checkpoint;
+    MatchCheckpoint checkpoint_state; // reused every turn
+    
+    // observers run on their own threads behind the event bus
+    std::unique_ptr<EventBus> event_bus;
+    std::vector<std::unique_ptr<EventSubscriber>> subscribers;
+    std::unique_ptr<StatsCollector> stats_collector;
     
     // status
     GameMode current_mode;
     int initial_life_points;
-    int current_turn;
     GameResult game_result;
     bool game_running;
     char current_player;
+    uint64_t rng_seed;
+    
+    // replay
+    std::string record_filename;
+    int replay_pace_ms; // < 0: replay headless at full speed
+    int replay_seek_turn;
+    bool headless;
+    bool replay_diverged;
+    Move last_move_a;
+    Move last_move_b;
+    bool collect_stats;
+    std::unique_ptr<TurnProfiler> profiler; // --profile, null when off
+    
+    // live spectator output
+    std::unique_ptr<SpectatorStream> spectator;
+    GameSnapshot observer_snapshot; // reused every turn
+    std::unique_ptr<SharedStatePublisher> shared_state; // for external monitors
+    MatchStatus shared_status;
+    std::unique_ptr<TuiRenderer> tui_renderer;
+    std::unique_ptr<RenderThread> render_thread;
+    int render_fps; // 0: draw synchronously after every turn
+    
+    // keyboard
+    std::unique_ptr<RawInput> raw_input;
+    std::unique_ptr<InputScript> input_script;
+    bool use_raw_input;
+    int move_timeout_ms;
+    bool ponder_enabled;
     
 public:
     GameEngine(GameMode mode, int life_points, const std::string& log_file);
@@ -44,56 +97,76 @@ public:
     bool setupTanks();
     bool setupAI();
     
-    // main loop
-    void runGame();
+    // main loop; false if the game could not start
+    bool runGame();
     bool gameLoop();
     bool processTurn();
     
-    bool processTankTurn(Tank& tank, char tank_id);
-    void processBulletMovement();
-    void processCollisions();
-    // void processMapShrink();
-    void processOutOfMapDamage();
-    
-    // check rules
-    GameResult checkGameEnd();
-    bool checkTankCollision();
-    void handleBulletHit(Bullet& bullet, Tank& tank);
-    void spawnBullet(Tank& tank);
+    bool processTankTurn(char tank_id);
     
     // input
     Move getPlayerMove(char tank_id);
     Move getAIMove(char tank_id);
     bool getInitialTankSetup(char tank_id, int& x, int& y, Direction& dir);
     
-    void updateGameState();
     void resetGame();
     void endGame();
     
+    // replay
+    void setRngSeed(uint64_t seed) { rng_seed = seed; }
+    void setRecordFile(const std::string& filename) { record_filename = filename; }
+    void setReplay(std::unique_ptr<ReplayReader> reader, int pace_ms);
+    void setReplaySeek(int turn) { replay_seek_turn = turn; }
+    bool seekReplay(int turn);
+    uint64_t computeStateHash() const { return core.computeStateHash(); }
+    
+    // events
+    void setCollectStats(bool enable) { collect_stats = enable; }
+    void setProfile(bool enable);
+    const TurnProfiler* getProfiler() const { return profiler.get(); }
+    const AIPlayer* getAIPlayer(char tank_id) const { return (tank_id == 'A') ? ai_player_a.get() : ai_player_b.get(); }
+    void publishEvent(const GameEvent& event) const { if (event_bus) event_bus->publish(event); }
+    
+    // spectate
+    bool setSpectate(const std::string& target);
+    bool setSharedState(const std::string& segment_name);
+    void setTui(bool enable);
+    void setRenderFps(int fps) { render_fps = fps; }
+    void setRawInput(bool enable, int timeout_ms) { use_raw_input = enable; move_timeout_ms = timeout_ms; }
+    void setPonder(bool enable) { ponder_enabled = enable; }
+    void setAILevel(int level) { ai_level = level; }
+    void setAIBudget(const SearchBudget& budget) { ai_budget = budget; }
+    void setAIDeadline(int ms) { ai_deadline_ms = ms; }
+    void setAIWeights(const AIWeights& weights) { ai_weights = weights; }
+    void setEndgameTable(const std::shared_ptr<const EndgameTable>& table) { endgame_table = table; }
+    void setInputScript(std::unique_ptr<InputScript> script) { input_script = std::move(script); }
+    void setHeadless(bool enable);
+    
+    // checkpoint
+    void setCheckpoint(const std::string& filename, int interval_turns);
+    void setResume(std::unique_ptr<MatchCheckpoint> checkpoint);
+    void buildCheckpoint(MatchCheckpoint& checkpoint) const;
+    
+    // snapshot
+    void captureSnapshot(GameSnapshot& snapshot) const { core.captureSnapshot(snapshot); }
+    void restoreSnapshot(const GameSnapshot& snapshot);
+    
     // get with const for other classes
-    const Tank& getTankA() const { return *tank_a; }
-    const Tank& getTankB() const { return *tank_b; }
-    const std::vector<std::unique_ptr<Bullet>>& getBullets() const { return bullets; }
-    const GameMap& getGameMap() const { return *game_map; }
+    const GameCore& getCore() const { return core; }
     GameMode getCurrentMode() const { return current_mode; }
-    int getCurrentTurn() const { return current_turn; }
+    int getCurrentTurn() const { return core.getCurrentTurn(); }
     int getInitialLifePoints() const { return initial_life_points; }
     GameResult getGameResult() const { return game_result; }
     bool isGameRunning() const { return game_running; }
     char getCurrentPlayer() const { return current_player; }
+    uint64_t getRngSeed() const { return rng_seed; }
+    bool isReplaying() const { return replay_reader != nullptr; }
+    bool hasReplayDiverged() const { return replay_diverged; }
     
     // get without const for internal classes
-    Tank& getTankA() { return *tank_a; }
-    Tank& getTankB() { return *tank_b; }
-    std::vector<std::unique_ptr<Bullet>>& getBullets() { return bullets; }
-    GameMap& getGameMap() { return *game_map; }
     Logger& getLogger() { return *logger; }
     UIManager& getUIManager() { return *ui_manager; }
 
-    Tank& getTankById(char tank_id);
-    const Tank& getTankById(char tank_id) const;
-    Tank& getOtherTank(char tank_id);
-    const Tank& getOtherTank(char tank_id) const;
     char getOtherTankId(char tank_id) const;
     void switchPlayer();
     
@@ -101,13 +174,16 @@ public:
     // bool isValidGameState() const;
 
 private:
-    void initializeComponents();
-    void cleanupBullets();
-    bool validateTankPosition(int x, int y) const;
-    bool areTanksColliding() const;
-    void logGameState() const;
-    void displayGameState() const;
-    bool checkBulletPathCollision(const Bullet& bullet, const Tank& tank) const;  
+    bool playTurn();
+    void displayGameState();
+    bool syncReplayTurn();
+    bool restoreCheckpoint(const MatchCheckpoint& checkpoint);
+    void updateCheckpoint();
+    void startEventConsumers();
+    void stopEventConsumers();
+    void publishError(const std::string& message);
+    void publishSpectatorTurn();
+    void publishSharedState();
 };
 
 #endif // GAME_ENGINE_H
\ No newline at end of file
@@ -0,0 +1,54 @@
+// game_event.h
+
+#ifndef GAME_EVENT_H
+#define GAME_EVENT_H
+
+#include <cstdint>
+#include <cstring>
+#include "common.h"
+
+enum GameEventType {
+    EV_GAME_START, EV_TANK_MOVE, EV_TANK_SHOOT, EV_BULLET_MOVE, EV_BULLET_HIT,
+    EV_TANK_DAMAGE, EV_MAP_SHRINK, EV_TURN_END, EV_GAME_END, EV_ERROR
+};
+
+enum DamageReason {
+    DAMAGE_BULLET_HIT, DAMAGE_OUT_OF_MAP
+};
+
+// fixed-size, trivially copyable so it can live in the event ring
+struct GameEvent {
+    uint8_t type;        // GameEventType
+    char tank_id;        // A or B, 0 if not tank related
+    uint8_t direction;   // Direction of the moved tank/bullet
+    uint8_t detail;      // DamageReason, GameMode or GameResult
+    int32_t turn;
+    int32_t x, y;
+    int32_t value;       // life points, damage, map size, ...
+    char text[44];       // error message, truncated
+
+    GameEvent() : type(EV_ERROR), tank_id(0), direction(0), detail(0),
+                  turn(0), x(0), y(0), value(0) {
+        text[0] = '\0';
+    }
+
+    GameEvent(GameEventType event_type, int event_turn) : GameEvent() {
+        type = static_cast<uint8_t>(event_type);
+        turn = event_turn;
+    }
+
+    void setText(const char* message) {
+        std::strncpy(text, message, sizeof(text) - 1);
+        text[sizeof(text) - 1] = '\0';
+    }
+};
+
+class GameEventHandler {
+public:
+    virtual ~GameEventHandler() {}
+    virtual void handleEvent(const GameEvent& event) = 0;
+    // called on the consumer thread when the producer overwrote unread events
+    virtual void handleOverrun(uint64_t dropped_events) { (void)dropped_events; }
+};
+
+#endif // GAME_EVENT_H
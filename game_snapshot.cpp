@@ -0,0 +1,67 @@
+// game_snapshot.cpp
+
+#include "game_snapshot.h"
+#include "binary_io.h"
+
+static const size_t SNAPSHOT_FIXED_SIZE = 4 + 1 + 4 + 2 * 7 + 2;
+static const size_t BULLET_RECORD_SIZE = 6;
+
+static void encodeTank(const TankSnapshot& tank, std::vector<uint8_t>& out) {
+    appendU16(out, static_cast<uint16_t>(tank.x));
+    appendU16(out, static_cast<uint16_t>(tank.y));
+    appendU8(out, static_cast<uint8_t>(tank.direction));
+    appendU8(out, static_cast<uint8_t>(tank.life_points));
+    appendU8(out, static_cast<uint8_t>(tank.shoot_counter));
+}
+
+static bool decodeTank(const uint8_t* in, TankSnapshot& tank) {
+    if (in[4] > D_Down) return false;
+    tank.x = static_cast<int16_t>(readU16(in));
+    tank.y = static_cast<int16_t>(readU16(in + 2));
+    tank.direction = static_cast<Direction>(in[4]);
+    tank.life_points = in[5];
+    tank.shoot_counter = in[6];
+    return true;
+}
+
+void encodeSnapshot(const GameSnapshot& snapshot, std::vector<uint8_t>& out) {
+    appendU32(out, static_cast<uint32_t>(snapshot.current_turn));
+    appendU8(out, static_cast<uint8_t>(snapshot.map_size));
+    appendU32(out, static_cast<uint32_t>(snapshot.map_turn_count));
+    encodeTank(snapshot.tank_a, out);
+    encodeTank(snapshot.tank_b, out);
+
+    appendU16(out, static_cast<uint16_t>(snapshot.bullets.size()));
+    for (const BulletSnapshot& bullet : snapshot.bullets) {
+        appendU16(out, static_cast<uint16_t>(bullet.x));
+        appendU16(out, static_cast<uint16_t>(bullet.y));
+        appendU8(out, static_cast<uint8_t>(bullet.direction | (bullet.active ? 0x4 : 0)));
+        appendU8(out, static_cast<uint8_t>(bullet.owner_id));
+    }
+}
+
+size_t decodeSnapshot(const uint8_t* data, size_t size, GameSnapshot& snapshot) {
+    if (size < SNAPSHOT_FIXED_SIZE) return 0;
+
+    snapshot.current_turn = static_cast<int>(readU32(data));
+    snapshot.map_size = data[4];
+    snapshot.map_turn_count = static_cast<int>(readU32(data + 5));
+    if (!decodeTank(data + 9, snapshot.tank_a)) return 0;
+    if (!decodeTank(data + 16, snapshot.tank_b)) return 0;
+
+    size_t bullet_count = readU16(data + 23);
+    size_t total = SNAPSHOT_FIXED_SIZE + bullet_count * BULLET_RECORD_SIZE;
+    if (size < total) return 0;
+
+    snapshot.bullets.resize(bullet_count);
+    const uint8_t* in = data + SNAPSHOT_FIXED_SIZE;
+    for (size_t i = 0; i < bullet_count; i++, in += BULLET_RECORD_SIZE) {
+        BulletSnapshot& bullet = snapshot.bullets[i];
+        bullet.x = static_cast<int16_t>(readU16(in));
+        bullet.y = static_cast<int16_t>(readU16(in + 2));
+        bullet.direction = static_cast<Direction>(in[4] & 0x3);
+        bullet.active = (in[4] & 0x4) != 0;
+        bullet.owner_id = static_cast<char>(in[5]);
+    }
+    return total;
+}
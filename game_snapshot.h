@@ -0,0 +1,46 @@
+// game_snapshot.h
+
+#ifndef GAME_SNAPSHOT_H
+#define GAME_SNAPSHOT_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "common.h"
+
+struct TankSnapshot {
+    int x, y;
+    Direction direction;
+    int life_points;
+    int shoot_counter;
+
+    TankSnapshot() : x(0), y(0), direction(D_Left), life_points(0), shoot_counter(0) {}
+};
+
+struct BulletSnapshot {
+    int x, y;
+    Direction direction;
+    char owner_id;
+    bool active;
+
+    BulletSnapshot() : x(0), y(0), direction(D_Left), owner_id('A'), active(true) {}
+};
+
+// full simulation state of a match at the end of a turn
+struct GameSnapshot {
+    int current_turn;
+    int map_size;
+    int map_turn_count;
+    TankSnapshot tank_a;
+    TankSnapshot tank_b;
+    std::vector<BulletSnapshot> bullets;
+
+    GameSnapshot() : current_turn(0), map_size(INITIAL_MAP_SIZE), map_turn_count(0) {}
+};
+
+// binary encoding shared by replay keyframes and checkpoints
+void encodeSnapshot(const GameSnapshot& snapshot, std::vector<uint8_t>& out);
+// returns the number of bytes consumed, 0 if the data is malformed
+size_t decodeSnapshot(const uint8_t* data, size_t size, GameSnapshot& snapshot);
+
+#endif // GAME_SNAPSHOT_H
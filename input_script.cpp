@@ -0,0 +1,155 @@
+// input_script.cpp
+
+#include "input_script.h"
+#include <cstring>
+
+static bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// one whitespace-separated token within [cursor, line_end)
+static bool readToken(const char*& cursor, const char* line_end, const char*& token, size_t& length) {
+    while (cursor < line_end && isSpace(*cursor)) cursor++;
+    token = cursor;
+    while (cursor < line_end && !isSpace(*cursor)) cursor++;
+    length = static_cast<size_t>(cursor - token);
+    return length > 0;
+}
+
+static bool tokenIs(const char* token, size_t length, const char* word) {
+    return std::strlen(word) == length && std::strncmp(token, word, length) == 0;
+}
+
+static bool parseNumber(const char* token, size_t length, uint64_t& value) {
+    value = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (token[i] < '0' || token[i] > '9') return false;
+        value = value * 10 + static_cast<uint64_t>(token[i] - '0');
+    }
+    return length > 0 && length <= 19;
+}
+
+static bool parseDirection(const char* token, size_t length, Direction& direction) {
+    if (length != 1) return false;
+    switch (token[0]) {
+        case 'L': case 'l': case '0': direction = D_Left; return true;
+        case 'U': case 'u': case '1': direction = D_Up; return true;
+        case 'R': case 'r': case '2': direction = D_Right; return true;
+        case 'D': case 'd': case '3': direction = D_Down; return true;
+        default: return false;
+    }
+}
+
+InputScript::InputScript()
+    : has_mode(false), mode(PVP), has_life(false), life_points(DEFAULT_LIFE_POINTS),
+      has_seed(false), seed(0), cursor(nullptr), end(nullptr), moves_read(0) {
+}
+
+InputScript::~InputScript() {}
+
+bool InputScript::open(const std::string& file_name) {
+    filename = file_name;
+    error.clear();
+    if (!file.open(file_name)) return fail(0, "cannot read file");
+
+    cursor = reinterpret_cast<const char*>(file.getData());
+    end = cursor + file.getSize();
+    moves_read = 0;
+    return parseHeader();
+}
+
+bool InputScript::fail(int line, const std::string& message) {
+    error = filename;
+    if (line > 0) error += ":" + std::to_string(line);
+    error += ": " + message;
+    return false;
+}
+
+bool InputScript::parseHeader() {
+    for (int line = 1; cursor < end; line++) {
+        const char* line_end = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+        if (!line_end) line_end = end;
+        const char* comment = static_cast<const char*>(std::memchr(cursor, '#', line_end - cursor));
+        const char* content_end = comment ? comment : line_end;
+
+        const char* token;
+        size_t length;
+        const char* scan = cursor;
+        cursor = (line_end < end) ? line_end + 1 : end;
+        if (!readToken(scan, content_end, token, length)) continue;
+
+        const char* value;
+        size_t value_length;
+        uint64_t number;
+        if (tokenIs(token, length, "moves")) {
+            return true; // the rest of the file is the move stream
+        } else if (tokenIs(token, length, "mode")) {
+            if (!readToken(scan, content_end, value, value_length)) return fail(line, "mode needs a value");
+            if (tokenIs(value, value_length, "PVP") || tokenIs(value, value_length, "pvp")) mode = PVP;
+            else if (tokenIs(value, value_length, "PVE") || tokenIs(value, value_length, "pve")) mode = PVE;
+            else return fail(line, "mode must be PVP or PVE");
+            has_mode = true;
+        } else if (tokenIs(token, length, "life")) {
+            if (!readToken(scan, content_end, value, value_length) || !parseNumber(value, value_length, number) ||
+                number < 1 || number > 100) return fail(line, "life must be 1-100");
+            life_points = static_cast<int>(number);
+            has_life = true;
+        } else if (tokenIs(token, length, "seed")) {
+            if (!readToken(scan, content_end, value, value_length) || !parseNumber(value, value_length, number)) {
+                return fail(line, "seed must be a number");
+            }
+            seed = number;
+            has_seed = true;
+        } else if (tokenIs(token, length, "A") || tokenIs(token, length, "B")) {
+            ScriptSetup& setup = setups[token[0] == 'A' ? 0 : 1];
+            uint64_t x, y;
+            const char* y_token;
+            const char* dir_token;
+            size_t y_length, dir_length;
+            if (!readToken(scan, content_end, value, value_length) || !parseNumber(value, value_length, x) ||
+                !readToken(scan, content_end, y_token, y_length) || !parseNumber(y_token, y_length, y) ||
+                !readToken(scan, content_end, dir_token, dir_length) ||
+                !parseDirection(dir_token, dir_length, setup.direction)) {
+                return fail(line, "setup must be: A|B x y direction");
+            }
+            setup.x = static_cast<int>(x);
+            setup.y = static_cast<int>(y);
+            setup.present = true;
+        } else {
+            return fail(line, "unknown keyword '" + std::string(token, length) + "'");
+        }
+    }
+    return fail(0, "no 'moves' section");
+}
+
+void InputScript::skipBlank() {
+    while (cursor < end) {
+        if (isSpace(*cursor)) {
+            cursor++;
+        } else if (*cursor == '#') {
+            while (cursor < end && *cursor != '\n') cursor++;
+        } else {
+            break;
+        }
+    }
+}
+
+bool InputScript::hasMoreMoves() {
+    skipBlank();
+    return cursor < end;
+}
+
+bool InputScript::nextMove(Move& move) {
+    skipBlank();
+    if (cursor >= end) return false;
+
+    switch (*cursor) {
+        case 'F': case 'f': case '0': move = M_Forward; break;
+        case 'L': case 'l': case '1': move = M_Left; break;
+        case 'R': case 'r': case '2': move = M_Right; break;
+        default: return false;
+    }
+    cursor++;
+    moves_read++;
+    return true;
+}
@@ -0,0 +1,79 @@
+// input_script.h
+
+#ifndef INPUT_SCRIPT_H
+#define INPUT_SCRIPT_H
+
+#include <string>
+#include <cstdint>
+#include "common.h"
+#include "mapped_file.h"
+
+// Scripted human input for PVP/PVE (--input-script, --batch). The script is
+// plain text, mapped and scanned in place:
+//
+//   # comment
+//   mode PVE          optional, overrides -m
+//   life 5            optional, overrides -p
+//   seed 42           optional, overrides --seed
+//   A 3 3 R           tank A setup: x y direction (L/U/R/D or 0-3)
+//   B 12 12 L         tank B setup, PVP only
+//   moves
+//   FFLR FRRF ...     one move per human tank per turn: F/L/R or 0/1/2;
+//                     in PVP A and B alternate. Whitespace and comments are ignored.
+struct ScriptSetup {
+    bool present;
+    int x, y;
+    Direction direction;
+
+    ScriptSetup() : present(false), x(0), y(0), direction(D_Left) {}
+};
+
+class InputScript {
+private:
+    MappedFile file;
+    std::string filename;
+    std::string error;
+
+    bool has_mode;
+    GameMode mode;
+    bool has_life;
+    int life_points;
+    bool has_seed;
+    uint64_t seed;
+    ScriptSetup setups[2];
+
+    const char* cursor; // next unread byte of the move section
+    const char* end;
+    int moves_read;
+
+public:
+    InputScript();
+    ~InputScript();
+
+    InputScript(const InputScript&) = delete;
+    InputScript& operator=(const InputScript&) = delete;
+
+    bool open(const std::string& file_name);
+    const std::string& getError() const { return error; }
+    const std::string& getFilename() const { return filename; }
+
+    bool hasMode() const { return has_mode; }
+    GameMode getMode() const { return mode; }
+    bool hasLifePoints() const { return has_life; }
+    int getLifePoints() const { return life_points; }
+    bool hasSeed() const { return has_seed; }
+    uint64_t getSeed() const { return seed; }
+    const ScriptSetup& getSetup(char tank_id) const { return setups[tank_id == 'A' ? 0 : 1]; }
+
+    bool hasMoreMoves();
+    // false once the script is used up or on a character that is not a move
+    bool nextMove(Move& move);
+    int getMovesRead() const { return moves_read; }
+
+private:
+    bool parseHeader();
+    bool fail(int line, const std::string& message);
+    void skipBlank();
+};
+
+#endif // INPUT_SCRIPT_H
@@ -6,7 +6,9 @@
 #include <ctime>
 
 Logger::Logger(const std::string& filename) 
-    : log_filename(filename), is_logging_enabled(true) {
+    : log_filename(filename), is_logging_enabled(true), stamp_time(0) {
+    stamp[0] = '\0';
+    line.reserve(256);
     openLogFile(filename);
 }
 
@@ -18,6 +20,7 @@ bool Logger::openLogFile(const std::string& filename) {
     closeLogFile(); // close existing file
     
     log_filename = filename;
+    if (filename.empty()) return false; // no log file wanted
     log_file.open(filename, std::ios::out | std::ios::app);
     
     if (log_file.is_open()) {
@@ -43,76 +46,164 @@ void Logger::enableLogging(bool enable) {
 void Logger::log(const std::string& message) {
     if (!is_logging_enabled) return;
     
-    std::string timestamp = getCurrentTimestamp();
+    line = message;
+    writeLine();
+}
+
+void Logger::writeLine() {
+    if (!is_logging_enabled || !log_file.is_open()) return;
     
-    // input
-    if (log_file.is_open()) {
-        log_file << "[" << timestamp << "] " << message << std::endl;
+    std::time_t now = std::time(nullptr);
+    if (now != stamp_time) {
+        std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", std::localtime(&now));
+        stamp_time = now;
     }
     
+    log_file << '[' << stamp << "] ";
+    log_file.write(line.data(), static_cast<std::streamsize>(line.size()));
+    log_file << '\n';
+    
     // also output to the terminal
-    // std::cout << "[LOG] " << message << std::endl;
+    // std::cout << "[LOG] " << line << std::endl;
+}
+
+void Logger::appendPosition(int x, int y) {
+    line += '(';
+    appendInt(line, x);
+    line += ", ";
+    appendInt(line, y);
+    line += ')';
 }
 
 void Logger::logTurn(int turn_number) {
-    std::stringstream ss;
-    ss << "Turn " << turn_number << " started";
-    log(ss.str());
+    line = "Turn ";
+    appendInt(line, turn_number);
+    line += " started";
+    writeLine();
 }
 
-void Logger::logTankMove(char tank_id, int x, int y, const std::string& direction) {
-    std::stringstream ss;
-    ss << "Tank " << tank_id << " moved to (" << x << ", " << y 
-       << ") facing " << direction;
-    log(ss.str());
+void Logger::logTankMove(char tank_id, int x, int y, const char* direction) {
+    line = "Tank ";
+    line += tank_id;
+    line += " moved to ";
+    appendPosition(x, y);
+    line += " facing ";
+    line += direction;
+    writeLine();
 }
 
 void Logger::logTankShoot(char tank_id, int bullet_x, int bullet_y) {
-    std::stringstream ss;
-    ss << "Tank " << tank_id << " shot bullet at (" << bullet_x << ", " << bullet_y << ")";
-    log(ss.str());
+    line = "Tank ";
+    line += tank_id;
+    line += " shot bullet at ";
+    appendPosition(bullet_x, bullet_y);
+    writeLine();
 }
 
-void Logger::logBulletMove(int x, int y, const std::string& direction) {
-    std::stringstream ss;
-    ss << "Bullet moved to (" << x << ", " << y << ") direction " << direction;
-    log(ss.str());
+void Logger::logBulletMove(int x, int y, const char* direction) {
+    line = "Bullet moved to ";
+    appendPosition(x, y);
+    line += " direction ";
+    line += direction;
+    writeLine();
 }
 
 void Logger::logBulletHit(char tank_id, int damage) {
-    std::stringstream ss;
-    ss << "Tank " << tank_id << " hit by bullet, took " << damage << " damage";
-    log(ss.str());
+    line = "Tank ";
+    line += tank_id;
+    line += " hit by bullet, took ";
+    appendInt(line, damage);
+    line += " damage";
+    writeLine();
 }
 
-void Logger::logTankDamage(char tank_id, int remaining_life, const std::string& reason) {
-    std::stringstream ss;
-    ss << "Tank " << tank_id << " damaged (" << reason 
-       << "), remaining life: " << remaining_life;
-    log(ss.str());
+void Logger::logTankDamage(char tank_id, int remaining_life, const char* reason) {
+    line = "Tank ";
+    line += tank_id;
+    line += " damaged (";
+    line += reason;
+    line += "), remaining life: ";
+    appendInt(line, remaining_life);
+    writeLine();
 }
 
 void Logger::logMapShrink(int new_size) {
-    std::stringstream ss;
-    ss << "Map shrunk to size " << new_size << "x" << new_size;
-    log(ss.str());
-}
-
-void Logger::logGameResult(const std::string& result) {
-    std::stringstream ss;
-    ss << "Game ended: " << result;
-    log(ss.str());
-}
-
-void Logger::logGameStart(const std::string& mode, int initial_life) {
-    std::stringstream ss;
-    ss << "Game started - Mode: " << mode << ", Initial Life: " << initial_life;
-    log(ss.str());
+    line = "Map shrunk to size ";
+    appendInt(line, new_size);
+    line += 'x';
+    appendInt(line, new_size);
+    writeLine();
+}
+
+void Logger::logGameResult(const char* result) {
+    line = "Game ended: ";
+    line += result;
+    writeLine();
+}
+
+void Logger::logGameStart(const char* mode, int initial_life) {
+    line = "Game started - Mode: ";
+    line += mode;
+    line += ", Initial Life: ";
+    appendInt(line, initial_life);
+    writeLine();
+}
+
+void Logger::logError(const char* error_message) {
+    line = "ERROR: ";
+    line += error_message;
+    writeLine();
+}
+
+void Logger::handleEvent(const GameEvent& event) {
+    Direction direction = static_cast<Direction>(event.direction);
+    switch (event.type) {
+        case EV_GAME_START: {
+            const char* mode = (event.detail == PVP) ? "PVP" : (event.detail == PVE) ? "PVE" : "DEMO";
+            logGameStart(mode, event.value);
+            break;
+        }
+        case EV_TANK_MOVE:
+            logTankMove(event.tank_id, event.x, event.y, directionName(direction));
+            break;
+        case EV_TANK_SHOOT:
+            logTankShoot(event.tank_id, event.x, event.y);
+            break;
+        case EV_BULLET_MOVE:
+            logBulletMove(event.x, event.y, directionName(direction));
+            break;
+        case EV_BULLET_HIT:
+            logBulletHit(event.tank_id, event.value);
+            break;
+        case EV_TANK_DAMAGE:
+            logTankDamage(event.tank_id, event.value,
+                          (event.detail == DAMAGE_OUT_OF_MAP) ? "out of map" : "bullet hit");
+            break;
+        case EV_MAP_SHRINK:
+            logMapShrink(event.value);
+            break;
+        case EV_TURN_END:
+            logTurn(event.turn);
+            flush(); // once a turn rather than after every line
+            break;
+        case EV_GAME_END:
+            switch (event.detail) {
+                case TANK_A_WIN: logGameResult("Tank A Wins"); break;
+                case TANK_B_WIN: logGameResult("Tank B Wins"); break;
+                case DRAW: logGameResult("Draw"); break;
+                default: logGameResult("Game ended unexpectedly"); break;
+            }
+            flush();
+            break;
+        case EV_ERROR:
+            logError(event.text);
+            break;
+    }
 }
 
-void Logger::logError(const std::string& error_message) {
+void Logger::handleOverrun(uint64_t dropped_events) {
     std::stringstream ss;
-    ss << "ERROR: " << error_message;
+    ss << "WARNING: logger fell behind the game, " << dropped_events << " events dropped";
     log(ss.str());
 }
 
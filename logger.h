@@ -6,12 +6,19 @@
 #include <string>
 #include <fstream>
 #include <iostream>
+#include <ctime>
+#include "game_event.h"
 
-class Logger {
+// runs on its own event bus consumer thread once the game has started;
+// every line is formatted into one reused buffer, so logging a turn does not allocate
+class Logger : public GameEventHandler {
 private:
     std::string log_filename;
     std::ofstream log_file;
     bool is_logging_enabled;
+    std::string line;
+    std::time_t stamp_time; // second the cached timestamp is for
+    char stamp[32];
 
 public:
     Logger(const std::string& filename = "tankwar.log");
@@ -23,21 +30,29 @@ public:
     
     void log(const std::string& message);
     void logTurn(int turn_number);
-    void logTankMove(char tank_id, int x, int y, const std::string& direction);
+    void logTankMove(char tank_id, int x, int y, const char* direction);
     void logTankShoot(char tank_id, int bullet_x, int bullet_y);
-    void logBulletMove(int x, int y, const std::string& direction);
+    void logBulletMove(int x, int y, const char* direction);
     void logBulletHit(char tank_id, int damage);
-    void logTankDamage(char tank_id, int remaining_life, const std::string& reason);
+    void logTankDamage(char tank_id, int remaining_life, const char* reason);
     void logMapShrink(int new_size);
-    void logGameResult(const std::string& result);
-    void logGameStart(const std::string& mode, int initial_life);
-    void logError(const std::string& error_message);
+    void logGameResult(const char* result);
+    void logGameStart(const char* mode, int initial_life);
+    void logError(const char* error_message);
+    
+    void handleEvent(const GameEvent& event) override;
+    void handleOverrun(uint64_t dropped_events) override;
     
     std::string getLogFilename() const { return log_filename; }
     bool isLoggingEnabled() const { return is_logging_enabled; }
     
     std::string getCurrentTimestamp() const;
     void flush();
+
+private:
+    // writes line with a timestamp in front
+    void writeLine();
+    void appendPosition(int x, int y);
 };
 
 #endif // LOGGER_H
\ No newline at end of file
@@ -2,6 +2,9 @@
 
 #include "game_engine.h"
 #include "command_parser.h"
+#include "benchmark.h"
+#include "batch_runner.h"
+#include "endgame_table.h"
 #include <iostream>
 #include <memory>
 
@@ -25,16 +28,99 @@ int main(int argc, char* argv[]) {
         }
         
         const GameConfig& config = parser.getConfig();
+        if (!config.bench_name.empty()) {
+            return runBenchmark(config.bench_name);
+        }
+        if (!config.batch_directory.empty()) {
+            return runScriptBatch(config.batch_directory, config);
+        }
         
-        auto game_engine = std::make_unique<GameEngine>(
-            config.mode,
-            config.initial_life_points,
-            config.log_filename
-        );
+        std::unique_ptr<GameEngine> game_engine;
+        if (!config.replay_filename.empty()) {
+            auto reader = std::make_unique<ReplayReader>();
+            if (!reader->open(config.replay_filename)) {
+                std::cerr << "Cannot read replay file: " << config.replay_filename << std::endl;
+                return 1;
+            }
+            const ReplayHeader& header = reader->getHeader();
+            game_engine = std::make_unique<GameEngine>(
+                header.mode,
+                header.initial_life_points,
+                config.log_filename
+            );
+            game_engine->setReplay(std::move(reader), config.replay_pace_ms);
+            game_engine->setReplaySeek(config.replay_seek_turn);
+        } else if (!config.resume_filename.empty()) {
+            auto checkpoint = std::make_unique<MatchCheckpoint>();
+            if (!CheckpointManager::load(config.resume_filename, *checkpoint)) {
+                std::cerr << "Cannot read checkpoint file: " << config.resume_filename << std::endl;
+                return 1;
+            }
+            game_engine = std::make_unique<GameEngine>(
+                checkpoint->mode,
+                checkpoint->initial_life_points,
+                config.log_filename
+            );
+            game_engine->setResume(std::move(checkpoint));
+        } else if (!config.input_script_filename.empty()) {
+            auto script = std::make_unique<InputScript>();
+            if (!script->open(config.input_script_filename)) {
+                std::cerr << "Cannot read input script: " << script->getError() << std::endl;
+                return 1;
+            }
+            game_engine = std::make_unique<GameEngine>(
+                script->hasMode() ? script->getMode() : config.mode,
+                script->hasLifePoints() ? script->getLifePoints() : config.initial_life_points,
+                config.log_filename
+            );
+            if (script->hasSeed()) game_engine->setRngSeed(script->getSeed());
+            else if (config.has_rng_seed) game_engine->setRngSeed(config.rng_seed);
+            game_engine->setRecordFile(config.record_filename);
+            game_engine->setInputScript(std::move(script));
+        } else {
+            game_engine = std::make_unique<GameEngine>(
+                config.mode,
+                config.initial_life_points,
+                config.log_filename
+            );
+            if (config.has_rng_seed) game_engine->setRngSeed(config.rng_seed);
+            game_engine->setRecordFile(config.record_filename);
+        }
+        
+        if (!config.checkpoint_filename.empty()) {
+            game_engine->setCheckpoint(config.checkpoint_filename, config.checkpoint_interval);
+        }
         
-        game_engine->runGame();
+        game_engine->setCollectStats(config.collect_stats);
+        game_engine->setProfile(config.profile);
+        game_engine->setTui(config.tui);
+        game_engine->setRenderFps(config.render_fps);
+        game_engine->setRawInput(config.raw_input, config.move_timeout_ms);
+        game_engine->setPonder(config.ponder);
+        game_engine->setAILevel(config.ai_level);
+        game_engine->setAIBudget(config.ai_budget);
+        game_engine->setAIDeadline(config.ai_deadline_ms);
+        game_engine->setAIWeights(config.ai_weights);
+        if (!config.tablebase_filename.empty()) {
+            auto table = std::make_shared<EndgameTable>();
+            std::string error;
+            if (!table->open(config.tablebase_filename, error)) {
+                std::cerr << "Cannot read tablebase: " << error << std::endl;
+                return 1;
+            }
+            game_engine->setEndgameTable(table);
+        }
+        if (!config.shared_state_name.empty() && !game_engine->setSharedState(config.shared_state_name)) {
+            std::cerr << "Cannot publish to shared memory: " << config.shared_state_name << std::endl;
+            return 1;
+        }
+        if (!config.spectate_target.empty() && !game_engine->setSpectate(config.spectate_target)) {
+            std::cerr << "Cannot open spectator output: " << config.spectate_target << std::endl;
+            return 1;
+        }
+        if (!game_engine->runGame()) return 1;
         
-        return 0;
+        return game_engine->hasReplayDiverged() ? 2 : 0;
         
     } catch (const std::exception& e) {
         std::cerr << "Fatal error: " << e.what() << std::endl;
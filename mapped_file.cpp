@@ -0,0 +1,61 @@
+// mapped_file.cpp
+
+#include "mapped_file.h"
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+MappedFile::MappedFile() : data(nullptr), size(0) {}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& file_name) {
+    close();
+#ifndef _WIN32
+    int fd = ::open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) return false;
+
+    data = static_cast<const uint8_t*>(mapped);
+    size = static_cast<size_t>(st.st_size);
+    return true;
+#else
+    std::ifstream file(file_name, std::ios::in | std::ios::binary);
+    if (!file.is_open()) return false;
+
+    fallback_data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (fallback_data.empty()) return false;
+    data = fallback_data.data();
+    size = fallback_data.size();
+    return true;
+#endif
+}
+
+void MappedFile::close() {
+#ifndef _WIN32
+    if (data && fallback_data.empty()) {
+        munmap(const_cast<uint8_t*>(data), size);
+    }
+#endif
+    fallback_data.clear();
+    data = nullptr;
+    size = 0;
+}
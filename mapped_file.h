@@ -0,0 +1,35 @@
+// mapped_file.h
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// A whole file mapped read-only. Where mmap is not available the file is
+// read into memory instead, behind the same interface.
+class MappedFile {
+private:
+    const uint8_t* data;
+    size_t size;
+    std::vector<uint8_t> fallback_data;
+
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // fails on a missing or empty file
+    bool open(const std::string& file_name);
+    void close();
+
+    bool isOpen() const { return data != nullptr; }
+    const uint8_t* getData() const { return data; }
+    size_t getSize() const { return size; }
+};
+
+#endif // MAPPED_FILE_H
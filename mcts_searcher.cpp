@@ -0,0 +1,194 @@
+// mcts_searcher.cpp
+
+#include "mcts_searcher.h"
+#include "game_core.h"
+#include <chrono>
+#include <cmath>
+
+static const double EXPLORATION = 0.7; // UCB constant for values in [0, 1]
+
+MctsSearcher::MctsSearcher()
+    : rng_state(1), last_playouts(0), total_playouts(0), total_nodes(0), searches(0), total_seconds(0) {
+}
+
+Move MctsSearcher::search(const GameCore& game, char tank_id, const SearchBudget& budget, uint64_t seed) {
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+    Clock::time_point deadline = start + std::chrono::milliseconds(budget.time_ms);
+
+    int node_limit = (budget.playouts > 0 && budget.playouts < MAX_NODES) ? budget.playouts + 1 : MAX_NODES;
+    if (nodes.capacity() < static_cast<size_t>(node_limit)) nodes.reserve(node_limit);
+    nodes.clear();
+    rng_state = (seed ^ 0x9E3779B97F4A7C15ULL) | 1;
+    root.capture(game, tank_id);
+    newNode();
+
+    uint64_t playouts = 0;
+    while (budget.playouts <= 0 || playouts < static_cast<uint64_t>(budget.playouts)) {
+        playout(node_limit);
+        playouts++;
+        if (budget.time_ms > 0 && (playouts & 31) == 0 && Clock::now() >= deadline) break;
+        if (budget.playouts <= 0 && budget.time_ms <= 0) break; // no budget: a single playout
+    }
+
+    // the most visited move is the most robust choice
+    int me = (tank_id == 'A') ? 0 : 1;
+    const Node& top = nodes[0];
+    int best = 0;
+    for (int m = 1; m < 3; m++) {
+        if (top.move_visits[me][m] > top.move_visits[me][best]) best = m;
+    }
+
+    last_playouts = playouts;
+    total_playouts += playouts;
+    total_nodes += nodes.size();
+    searches++;
+    total_seconds += std::chrono::duration<double>(Clock::now() - start).count();
+    return static_cast<Move>(best);
+}
+
+int32_t MctsSearcher::newNode() {
+    Node node;
+    for (int32_t& child : node.children) child = -1;
+    node.visits = 0;
+    for (int p = 0; p < 2; p++) {
+        for (int m = 0; m < 3; m++) {
+            node.move_visits[p][m] = 0;
+            node.move_value[p][m] = 0.0f;
+        }
+    }
+    nodes.push_back(node); // within the reserved capacity, never reallocates
+    return static_cast<int32_t>(nodes.size() - 1);
+}
+
+// select down the tree, expand one node, roll out, back up the value for A
+void MctsSearcher::playout(int node_limit) {
+    scratch.copyFrom(root);
+    int32_t node = 0;
+    int depth = 0;
+    double value;
+
+    for (;;) {
+        int move_a = selectMove(nodes[node], 0);
+        int move_b = selectMove(nodes[node], 1);
+        path[depth].node = node;
+        path[depth].move_a = static_cast<uint8_t>(move_a);
+        path[depth].move_b = static_cast<uint8_t>(move_b);
+        depth++;
+
+        GameResult result = scratch.step(static_cast<Move>(move_a), static_cast<Move>(move_b));
+        if (result != GAME_CONTINUE) {
+            value = resultValue(result);
+            break;
+        }
+
+        int32_t child = nodes[node].children[move_a * 3 + move_b];
+        if (child < 0) {
+            if (static_cast<int>(nodes.size()) < node_limit && depth < MAX_TREE_DEPTH) {
+                child = newNode();
+                nodes[node].children[move_a * 3 + move_b] = child;
+            }
+            value = rollout(scratch);
+            break;
+        }
+        if (depth == MAX_TREE_DEPTH) {
+            value = rollout(scratch);
+            break;
+        }
+        node = child;
+    }
+
+    for (int i = 0; i < depth; i++) {
+        Node& step = nodes[path[i].node];
+        step.visits++;
+        step.move_visits[0][path[i].move_a]++;
+        step.move_value[0][path[i].move_a] += static_cast<float>(value);
+        step.move_visits[1][path[i].move_b]++;
+        step.move_value[1][path[i].move_b] += static_cast<float>(1.0 - value);
+    }
+}
+
+int MctsSearcher::selectMove(const Node& node, int player) const {
+    for (int m = 0; m < 3; m++) {
+        if (node.move_visits[player][m] == 0) return m;
+    }
+
+    double log_visits = std::log(static_cast<double>(node.visits));
+    int best = 0;
+    double best_score = -1.0;
+    for (int m = 0; m < 3; m++) {
+        double visits = node.move_visits[player][m];
+        double score = node.move_value[player][m] / visits + EXPLORATION * std::sqrt(log_visits / visits);
+        if (score > best_score) {
+            best_score = score;
+            best = m;
+        }
+    }
+    return best;
+}
+
+double MctsSearcher::rollout(SimState& state) {
+    for (int turn = 0; turn < ROLLOUT_TURNS; turn++) {
+        Move move_a = rolloutMove(state, 0);
+        Move move_b = rolloutMove(state, 1);
+        GameResult result = state.step(move_a, move_b);
+        if (result != GAME_CONTINUE) return resultValue(result);
+    }
+    return evaluate(state);
+}
+
+// random among the moves that stay on next turn's map; half the time take
+// the move that lines the tank up to shoot, if there is one
+Move MctsSearcher::rolloutMove(const SimState& state, int tank) {
+    static const int DX[4] = {-1, 0, 1, 0};
+    static const int DY[4] = {0, -1, 0, 1};
+
+    const SimTank& me = state.tanks[tank];
+    const SimTank& enemy = state.tanks[1 - tank];
+    int next_size = state.map_size;
+    if ((state.map_turn_count + 1) % MAP_SHRINK_INTERVAL == 0 && next_size > 2) next_size -= 2;
+    int low = INITIAL_MAP_SIZE / 2 - next_size / 2;
+    int high = INITIAL_MAP_SIZE / 2 + next_size / 2 - 1;
+
+    Move safe[3];
+    int safe_count = 0;
+    int aiming = -1;
+    for (int m = 0; m < 3; m++) {
+        Direction dir = (m == M_Left) ? turnLeft(me.direction) : (m == M_Right) ? turnRight(me.direction) : me.direction;
+        int x = me.x + ((m == M_Forward) ? DX[dir] : 0);
+        int y = me.y + ((m == M_Forward) ? DY[dir] : 0);
+        if (x < low || x > high || y < low || y > high) continue;
+        safe[safe_count++] = static_cast<Move>(m);
+
+        int dx = enemy.x - x, dy = enemy.y - y;
+        if ((dy == 0 && dx * DX[dir] > 0) || (dx == 0 && dy * DY[dir] > 0)) aiming = m;
+    }
+
+    uint32_t random = nextRandom();
+    if (aiming >= 0 && (random & 1)) return static_cast<Move>(aiming);
+    if (safe_count == 0) return static_cast<Move>((random >> 1) % 3);
+    return safe[(random >> 1) % safe_count];
+}
+
+// value for A of an unfinished state: the life lead, squashed into (0, 1)
+double MctsSearcher::evaluate(const SimState& state) {
+    int life_a = state.tanks[0].life_points;
+    int life_b = state.tanks[1].life_points;
+    return 0.5 + 0.5 * (life_a - life_b) / static_cast<double>(life_a + life_b + 2);
+}
+
+double MctsSearcher::resultValue(GameResult result) {
+    switch (result) {
+        case TANK_A_WIN: return 1.0;
+        case TANK_B_WIN: return 0.0;
+        default:         return 0.5;
+    }
+}
+
+// xorshift64*, upper half
+uint32_t MctsSearcher::nextRandom() {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return static_cast<uint32_t>((rng_state * 0x2545F4914F6CDD1DULL) >> 32);
+}
@@ -0,0 +1,72 @@
+// mcts_searcher.h
+
+#ifndef MCTS_SEARCHER_H
+#define MCTS_SEARCHER_H
+
+#include <vector>
+#include <cstdint>
+#include "common.h"
+#include "sim_state.h"
+#include "search_budget.h"
+
+class GameCore;
+
+// Level-4 AI: Monte-Carlo tree search over simultaneous moves (decoupled
+// UCT). Both tanks pick their move at a node independently from their own
+// per-move statistics; a child exists per joint move. Playouts run on flat
+// SimState copies with a cheap stay-on-the-map random policy, cut off after
+// ROLLOUT_TURNS and scored by life difference.
+class MctsSearcher {
+public:
+    static const int ROLLOUT_TURNS = 16;
+    static const int MAX_TREE_DEPTH = 64;
+    static const int MAX_NODES = 1 << 18; // cap for time-only budgets
+
+private:
+    struct Node {
+        int32_t children[9];     // by move_a * 3 + move_b, -1: not expanded
+        uint32_t visits;
+        uint32_t move_visits[2][3];
+        float move_value[2][3];  // summed, each tank from its own side
+    };
+    struct PathStep {
+        int32_t node;
+        uint8_t move_a, move_b;
+    };
+
+    std::vector<Node> nodes; // pool, capacity kept between searches
+    SimState root;
+    SimState scratch;
+    PathStep path[MAX_TREE_DEPTH];
+    uint64_t rng_state;
+
+    // statistics
+    uint64_t last_playouts;
+    uint64_t total_playouts;
+    uint64_t total_nodes;
+    uint64_t searches;
+    double total_seconds;
+
+public:
+    MctsSearcher();
+
+    Move search(const GameCore& game, char tank_id, const SearchBudget& budget, uint64_t seed);
+
+    uint64_t getLastPlayouts() const { return last_playouts; }
+    uint64_t getTotalPlayouts() const { return total_playouts; }
+    uint64_t getTotalNodes() const { return total_nodes; }
+    uint64_t getSearches() const { return searches; }
+    double getTotalSeconds() const { return total_seconds; }
+
+private:
+    int32_t newNode();
+    void playout(int node_limit);
+    int selectMove(const Node& node, int player) const;
+    double rollout(SimState& state);
+    Move rolloutMove(const SimState& state, int tank);
+    static double evaluate(const SimState& state);
+    static double resultValue(GameResult result);
+    uint32_t nextRandom();
+};
+
+#endif // MCTS_SEARCHER_H
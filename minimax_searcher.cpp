@@ -0,0 +1,354 @@
+// minimax_searcher.cpp
+
+#include "minimax_searcher.h"
+#include "game_core.h"
+#include "worker_pool.h"
+#include "bullet_threats.h"
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+
+static const int INFINITE_SCORE = 2 * MinimaxSearcher::WIN_SCORE;
+static const int DX[4] = {-1, 0, 1, 0}; // by Direction: left, up, right, down
+static const int DY[4] = {0, -1, 0, 1};
+
+static int64_t steadyNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+MinimaxSearcher::MinimaxSearcher()
+    : table(static_cast<size_t>(1) << TABLE_BITS), generation(0), me(0),
+      timed(false), aborted(false), deadline_ns(0), root_best(0), refutation(0) {
+    for (TableEntry& entry : table) {
+        entry.key = 0;
+        entry.generation = 0;
+        entry.bound = BOUND_NONE;
+    }
+    for (int i = 0; i < ROOT_PAIRS; i++) {
+        pair_low[i] = -INFINITE_SCORE;
+        pair_high[i] = INFINITE_SCORE;
+    }
+}
+
+// root pairs to search at once, each with its window; the searchers are the
+// tasks' own, so a thread only ever touches the searcher of the task it took
+struct MinimaxSearcher::PairJob : WorkerPool::Job {
+    MinimaxSearcher& owner;
+    int depth;
+    int pairs[ROOT_PAIRS];
+    int alphas[ROOT_PAIRS], betas[ROOT_PAIRS];
+    int count;
+
+    PairJob(MinimaxSearcher& owner, int depth) : owner(owner), depth(depth), count(0) {}
+    void add(int pair, int alpha, int beta) {
+        pairs[count] = pair;
+        alphas[count] = alpha;
+        betas[count] = beta;
+        count++;
+    }
+    void runTask(int task) override {
+        int pair = pairs[task];
+        int value = owner.pair_searchers[pair]->searchPair(pair, depth, alphas[task], betas[task]);
+        // fail-soft: outside the window the value is only a bound
+        if (value > alphas[task]) owner.pair_low[pair] = value;
+        if (value < betas[task]) owner.pair_high[pair] = value;
+    }
+};
+
+Move MinimaxSearcher::search(const GameCore& game, char tank_id, const SearchBudget& budget, const int hint[3],
+                             WorkerPool* pool) {
+    int64_t start = steadyNanos();
+    stack[0].capture(game, tank_id);
+
+    // seed the ordering with the heuristic: its favourite move is tried first
+    int ranked[3] = {0, 1, 2};
+    std::stable_sort(ranked, ranked + 3, [hint](int a, int b) { return hint[a] > hint[b]; });
+    begin(budget, start, (tank_id == 'A') ? 0 : 1, ranked);
+
+    if (pool) {
+        if (pair_searchers.empty()) {
+            for (int i = 0; i < ROOT_PAIRS; i++) pair_searchers.push_back(std::make_unique<MinimaxSearcher>());
+        }
+        for (std::unique_ptr<MinimaxSearcher>& pair : pair_searchers) {
+            pair->begin(budget, start, me, ranked);
+            pair->stack[0].copyFrom(stack[0]);
+        }
+        refutation = 0;
+    }
+
+    int depth_limit = std::max(1, std::min(budget.depth, MAX_SEARCH_DEPTH));
+    int best = ranked[0];
+    uint64_t previous_pass = 0;
+    for (int depth = 1; depth <= depth_limit; depth++) {
+        uint64_t before = stats.nodes;
+        int value = pool ? searchRootPairs(depth, best, *pool) : searchNode(0, depth, -INFINITE_SCORE, INFINITE_SCORE);
+        if (aborted) break; // an unfinished pass is not trusted
+        best = root_best;
+        stats.iterations++;
+
+        uint64_t pass = stats.nodes - before;
+        if (previous_pass > 0) {
+            stats.branching_sum += static_cast<double>(pass) / previous_pass;
+            stats.branching_count++;
+        }
+        previous_pass = pass;
+        if (std::abs(value) >= WIN_SCORE / 2) break; // decided either way
+    }
+
+    stats.seconds += (steadyNanos() - start) / 1e9;
+    return static_cast<Move>(best);
+}
+
+void MinimaxSearcher::begin(const SearchBudget& budget, int64_t start, int player, const int ranked[3]) {
+    timed = budget.time_ms > 0;
+    deadline_ns = start + static_cast<int64_t>(budget.time_ms) * 1000000;
+    aborted = false;
+    if (++generation == 0) generation = 1; // 0 marks never written entries
+
+    me = player;
+    for (int p = 0; p < 2; p++) {
+        for (int m = 0; m < 3; m++) history[p][m] = 0;
+    }
+    for (int i = 0; i < 3; i++) history[me][ranked[i]] = 2 - i;
+}
+
+// the root of searchNode with its pairs searched apart, in up to three pool
+// runs; the values that decide the move are exact, as at the serial root
+int MinimaxSearcher::searchRootPairs(int depth, int first_move, WorkerPool& pool) {
+    const SimState& state = stack[0];
+    // with A's move made only the first enemy move is searched: pairs 0, 3, 6
+    int enemy_moves = state.a_moved ? 1 : 3;
+    int first_reply = state.a_moved ? 0 : refutation;
+    for (int pair = 0; pair < ROOT_PAIRS; pair++) {
+        pair_low[pair] = -INFINITE_SCORE;
+        pair_high[pair] = INFINITE_SCORE;
+    }
+    pass_profile.runs = 0;
+    stats.nodes++; // the root itself
+
+    PairJob lead(*this, depth);
+    lead.add(first_move * 3 + first_reply, -INFINITE_SCORE, INFINITE_SCORE);
+    if (!runPairs(lead, pool)) return 0;
+    int lead_value = pair_low[first_move * 3 + first_reply];
+
+    // the first move's other replies only matter below the lead; the other
+    // moves' pairs are placed below, on or above it
+    PairJob scout(*this, depth);
+    for (int mine = 0; mine < 3; mine++) {
+        for (int j = 0; j < enemy_moves; j++) {
+            if (mine != first_move) scout.add(mine * 3 + j, lead_value - 1, lead_value + 1);
+            else if (j != first_reply) scout.add(mine * 3 + j, -INFINITE_SCORE, lead_value);
+        }
+    }
+    if (!runPairs(scout, pool)) return 0;
+
+    // below the lead the first move's replies are exact
+    int first_value = lead_value;
+    refutation = first_reply;
+    for (int j = 0; j < enemy_moves; j++) {
+        if (pair_high[first_move * 3 + j] < first_value) {
+            first_value = pair_high[first_move * 3 + j];
+            refutation = j;
+        }
+    }
+
+    // a move with a reply below the first is out, one with every reply on or
+    // above it and one on it ties; the rest, with replies still unplaced or all
+    // above, are searched exactly
+    PairJob exact(*this, depth);
+    bool out[3] = {true, true, true};
+    for (int mine = 0; mine < 3; mine++) {
+        if (mine == first_move) continue;
+        int low = INFINITE_SCORE, high = INFINITE_SCORE;
+        for (int j = 0; j < enemy_moves; j++) {
+            low = std::min(low, pair_low[mine * 3 + j]);
+            high = std::min(high, pair_high[mine * 3 + j]);
+        }
+        out[mine] = high < first_value;
+        if (out[mine] || (low == first_value && high == first_value)) continue;
+        for (int j = 0; j < enemy_moves; j++) {
+            int pair = mine * 3 + j;
+            if (pair_low[pair] != pair_high[pair]) exact.add(pair, first_value - 1, INFINITE_SCORE);
+        }
+    }
+    if (exact.count > 0 && !runPairs(exact, pool)) return 0;
+    last_pass = pass_profile;
+
+    int best = first_value;
+    int best_move = first_move;
+    int rotation = (state.turn + me) % 3;
+    for (int mine = 0; mine < 3; mine++) {
+        if (out[mine]) continue;
+        int worst = INFINITE_SCORE;
+        for (int j = 0; j < enemy_moves; j++) worst = std::min(worst, pair_high[mine * 3 + j]);
+        if (worst > best || (worst == best && (mine + 3 - rotation) % 3 < (best_move + 3 - rotation) % 3)) {
+            best = worst;
+            best_move = mine;
+        }
+    }
+    root_best = best_move;
+    return best;
+}
+
+// false if the deadline cut a task short
+bool MinimaxSearcher::runPairs(PairJob& job, WorkerPool& pool) {
+    pool.run(job, job.count);
+
+    int run = pass_profile.runs++;
+    pass_profile.tasks[run] = job.count;
+    for (int t = 0; t < job.count; t++) {
+        const MinimaxSearcher& searcher = *pair_searchers[job.pairs[t]];
+        if (searcher.aborted) aborted = true;
+        pass_profile.nodes[run][t] = searcher.stats.nodes;
+        stats.nodes += searcher.stats.nodes;
+        stats.tt_probes += searcher.stats.tt_probes;
+        stats.tt_hits += searcher.stats.tt_hits;
+        stats.tt_cutoffs += searcher.stats.tt_cutoffs;
+    }
+    return !aborted;
+}
+
+// on a pair's own searcher, whose stack[0] holds the root; fail-soft like
+// searchNode. Statistics are of this search only.
+int MinimaxSearcher::searchPair(int pair, int depth, int alpha, int beta) {
+    stats = Stats();
+    int mine = pair / 3, theirs = pair % 3;
+    SimState& child = stack[1];
+    child.copyFrom(stack[0]);
+    GameResult result = (me == 0) ? child.step(static_cast<Move>(mine), static_cast<Move>(theirs))
+                                  : child.step(static_cast<Move>(theirs), static_cast<Move>(mine));
+    if (result != GAME_CONTINUE) return resultScore(result, child);
+    return searchNode(1, depth - 1, alpha, beta);
+}
+
+int MinimaxSearcher::searchNode(int ply, int depth, int alpha, int beta) {
+    stats.nodes++;
+    // before the leaf test: most nodes are leaves, and a check they skipped
+    // could leave the clock unread for many times 1024 nodes
+    if (timed && (stats.nodes & 1023) == 0 && steadyNanos() >= deadline_ns) {
+        aborted = true;
+        return 0;
+    }
+    const SimState& state = stack[ply];
+    if (depth == 0) return evaluate(state);
+
+    uint64_t key = state.hash();
+    TableEntry& entry = table[key & ((static_cast<size_t>(1) << TABLE_BITS) - 1)];
+    int table_move = -1;
+    stats.tt_probes++;
+    if (entry.generation == generation && entry.key == key) {
+        stats.tt_hits++;
+        table_move = entry.best_move;
+        // only a value of this very depth: the hash leaves out the turn, so a
+        // position can recur deeper in the tree, and a deeper value taken from
+        // there would make the result depend on the order of the search
+        if (entry.depth == depth && ply > 0) {
+            if (entry.bound == BOUND_EXACT ||
+                (entry.bound == BOUND_LOWER && entry.value >= beta) ||
+                (entry.bound == BOUND_UPPER && entry.value <= alpha)) {
+                stats.tt_cutoffs++;
+                return entry.value;
+            }
+        }
+    }
+
+    int my_order[3], enemy_order[3];
+    orderMoves(me, table_move, my_order);
+    orderMoves(1 - me, -1, enemy_order);
+
+    // when B decides, A's move of this turn is made: one answer covers them all
+    int enemy_moves = state.a_moved ? 1 : 3;
+    int original_alpha = alpha;
+    int best = -INFINITE_SCORE;
+    int best_move = my_order[0];
+    SimState& child = stack[ply + 1];
+    // at the root equal moves are resolved exactly and taken in turn, offset per
+    // tank: two level-5 tanks from mirrored starts would otherwise mirror each
+    // other forever on the last 2x2 map, where they cannot hit each other
+    int tie_offset = (ply == 0) ? 1 : 0;
+    int rotation = (state.turn + me) % 3;
+    for (int i = 0; i < 3; i++) {
+        int mine = my_order[i];
+        int floor = std::max(alpha, best) - tie_offset;
+        // the enemy answers knowing our move, so our move is worth its worst case
+        int worst = INFINITE_SCORE;
+        for (int j = 0; j < enemy_moves; j++) {
+            int theirs = enemy_order[j];
+            child.copyFrom(state);
+            GameResult result = (me == 0) ? child.step(static_cast<Move>(mine), static_cast<Move>(theirs))
+                                          : child.step(static_cast<Move>(theirs), static_cast<Move>(mine));
+            int value = (result != GAME_CONTINUE) ? resultScore(result, child)
+                        : searchNode(ply + 1, depth - 1, floor, std::min(beta, worst));
+            if (aborted) return 0;
+            if (value < worst) worst = value;
+            if (worst <= floor) {
+                history[1 - me][theirs] += depth * depth;
+                break; // no better than a move we already have
+            }
+        }
+        if (worst > best ||
+            (ply == 0 && worst == best && (mine + 3 - rotation) % 3 < (best_move + 3 - rotation) % 3)) {
+            best = worst;
+            best_move = mine;
+        }
+        if (best >= beta) {
+            history[me][mine] += depth * depth;
+            break;
+        }
+    }
+
+    if (ply == 0) root_best = best_move;
+    entry.key = key;
+    entry.value = best;
+    entry.generation = generation;
+    entry.depth = static_cast<uint8_t>(depth);
+    entry.bound = (best <= original_alpha) ? BOUND_UPPER : (best >= beta) ? BOUND_LOWER : BOUND_EXACT;
+    entry.best_move = static_cast<uint8_t>(best_move);
+    return best;
+}
+
+// table move first, then by history; ties keep the natural order, so the result is stable
+void MinimaxSearcher::orderMoves(int player, int preferred, int order[3]) const {
+    order[0] = 0; order[1] = 1; order[2] = 2;
+    const int* weights = history[player];
+    std::stable_sort(order, order + 3, [weights, preferred](int a, int b) {
+        if ((a == preferred) != (b == preferred)) return a == preferred;
+        return weights[a] > weights[b];
+    });
+}
+
+// from our side: life lead, staying on the map near the centre, the line of fire
+int MinimaxSearcher::evaluate(const SimState& state) const {
+    // enemy bullets that reach each tank within two turns if it stays
+    int threats[2];
+    countBulletThreats(state, threats);
+
+    int score = 0;
+    for (int t = 0; t < 2; t++) {
+        const SimTank& tank = state.tanks[t];
+        const SimTank& other = state.tanks[1 - t];
+        int value = 100 * tank.life_points;
+
+        if (!state.isInBounds(tank.x, tank.y)) value -= 60;
+        value -= std::abs(2 * tank.x - (INITIAL_MAP_SIZE - 1)) + std::abs(2 * tank.y - (INITIAL_MAP_SIZE - 1));
+
+        int dx = other.x - tank.x, dy = other.y - tank.y;
+        if ((dy == 0 && dx * DX[tank.direction] >= BULLET_SPAWN_DISTANCE) ||
+            (dx == 0 && dy * DY[tank.direction] >= BULLET_SPAWN_DISTANCE)) value += 15;
+
+        value -= 40 * threats[t];
+
+        score += (t == me) ? value : -value;
+    }
+    return score;
+}
+
+int MinimaxSearcher::resultScore(GameResult result, const SimState& state) const {
+    // on the last 2x2 map tanks side by side can never hit each other: prefer
+    // the draw to circling forever
+    if (result == DRAW) return (state.map_size <= 2) ? 1 : 0;
+    int margin = state.tanks[me].life_points - state.tanks[1 - me].life_points;
+    bool won = (result == TANK_A_WIN) == (me == 0);
+    return won ? WIN_SCORE + margin : -WIN_SCORE + margin;
+}
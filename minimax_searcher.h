@@ -0,0 +1,120 @@
+// minimax_searcher.h
+
+#ifndef MINIMAX_SEARCHER_H
+#define MINIMAX_SEARCHER_H
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "common.h"
+#include "sim_state.h"
+#include "search_budget.h"
+
+class GameCore;
+class WorkerPool;
+
+// Level-5 AI: deterministic paranoid minimax with alpha-beta. A turn is a
+// 3x3 matrix game; the searcher maximizes over its own move and lets the
+// enemy answer knowing it, so the value is a guaranteed lower bound.
+// Iterative deepening up to budget.depth turns fills a transposition table
+// keyed by SimState::hash whose best moves order the next, deeper pass.
+// Without a time limit the chosen move only depends on the position.
+//
+// With a worker pool each pass searches the (own move, enemy move) pairs at
+// the root as tasks of their own, each on a searcher of its own kept from pass
+// to pass. The last pass's best move against its last refutation goes first,
+// with a full window; then, all at once, that move's other replies only below
+// its value and the other moves' pairs in a window just around it, which tells
+// whether they fall short of it, tie it or beat it; last, only moves that may
+// beat the first are searched exactly. No task reads another's table and the
+// windows only depend on values, so the move, and even the node count, do not
+// depend on the number of threads or on which thread ran what. The move is the
+// serial search's too: the table only takes values of the exact depth, so both
+// find the same values.
+class MinimaxSearcher {
+public:
+    static const int WIN_SCORE = 100000;
+    static const int TABLE_BITS = 16;
+
+    // how the last completed pass with a pool split: the pairs' node counts, per
+    // pool run in task order
+    struct PassProfile {
+        int runs;
+        int tasks[3];
+        uint64_t nodes[3][9];
+        PassProfile() : runs(0) {}
+    };
+
+    struct Stats {
+        uint64_t nodes;       // positions searched, leaves included
+        uint64_t tt_probes;
+        uint64_t tt_hits;     // probes that found the position, at least its best move
+        uint64_t tt_cutoffs;  // hits whose stored value settled the node
+        uint64_t iterations;  // completed deepening passes
+        double branching_sum; // nodes(d) / nodes(d - 1), summed over the passes
+        uint64_t branching_count;
+        double seconds;
+
+        Stats() : nodes(0), tt_probes(0), tt_hits(0), tt_cutoffs(0), iterations(0), branching_sum(0), branching_count(0), seconds(0) {}
+    };
+
+private:
+    enum Bound : uint8_t { BOUND_NONE, BOUND_EXACT, BOUND_LOWER, BOUND_UPPER };
+
+    static const int ROOT_PAIRS = 9; // by own move * 3 + enemy move
+    struct PairJob;
+
+    struct TableEntry {
+        uint64_t key;
+        int32_t value;
+        uint16_t generation;
+        uint8_t depth;
+        uint8_t bound;
+        uint8_t best_move;
+    };
+
+    std::vector<TableEntry> table; // allocated once, stale entries told apart by generation
+    uint16_t generation;
+    SimState stack[MAX_SEARCH_DEPTH + 1]; // one state per ply
+    int me;                // 0: tank A, 1: tank B
+    int history[2][3];     // cutoff weights per player and move, seeded from the AI's scores
+
+    // time limit
+    bool timed;
+    bool aborted;
+    int64_t deadline_ns; // steady clock
+    int root_best;
+
+    // with a pool: one searcher per root pair
+    std::vector<std::unique_ptr<MinimaxSearcher>> pair_searchers;
+    int pair_low[ROOT_PAIRS];  // bounds on each pair's value found so far in the pass
+    int pair_high[ROOT_PAIRS];
+    int refutation; // the enemy move that held the best move lowest in the last pass
+    PassProfile pass_profile;
+    PassProfile last_pass;
+
+    Stats stats;
+
+public:
+    MinimaxSearcher();
+
+    // hint: the AI's own heuristic score of each move, used to order the first pass.
+    // pool: split the root over its threads; the move is the same without it
+    Move search(const GameCore& game, char tank_id, const SearchBudget& budget, const int hint[3],
+                WorkerPool* pool = nullptr);
+
+    const Stats& getStats() const { return stats; }
+    const PassProfile& getLastPass() const { return last_pass; }
+
+private:
+    void begin(const SearchBudget& budget, int64_t start, int player, const int ranked[3]);
+    int searchRootPairs(int depth, int first_move, WorkerPool& pool);
+    bool runPairs(PairJob& job, WorkerPool& pool);
+    int searchPair(int pair, int depth, int alpha, int beta);
+    int searchNode(int ply, int depth, int alpha, int beta);
+    int evaluate(const SimState& state) const;
+    int resultScore(GameResult result, const SimState& state) const;
+    void orderMoves(int player, int preferred, int order[3]) const;
+};
+
+#endif // MINIMAX_SEARCHER_H
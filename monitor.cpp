@@ -0,0 +1,183 @@
+// monitor.cpp
+// tankwar-monitor: polls the shared-memory slots of all running games and
+// prints aggregate status, without ever blocking the games it watches.
+
+#include "shared_state.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <ctime>
+#include <thread>
+#include <chrono>
+#include <getopt.h>
+
+#ifndef _WIN32
+#include <signal.h>
+#include <cerrno>
+#endif
+
+struct SlotHistory {
+    int32_t pid;
+    int32_t turn;
+    SlotHistory() : pid(0), turn(0) {}
+};
+
+struct Totals {
+    int running, finished, orphaned, unreadable;
+    int by_mode[3];
+    int wins_a, wins_b, draws;
+    long long turns, bullets, advanced_turns;
+
+    Totals() : running(0), finished(0), orphaned(0), unreadable(0),
+               wins_a(0), wins_b(0), draws(0), turns(0), bullets(0), advanced_turns(0) {
+        by_mode[0] = by_mode[1] = by_mode[2] = 0;
+    }
+};
+
+static bool isAlive(int32_t pid) {
+#ifndef _WIN32
+    return pid > 0 && !(kill(pid, 0) != 0 && errno == ESRCH);
+#else
+    return pid > 0;
+#endif
+}
+
+static const char* modeName(int32_t mode) {
+    switch (mode) {
+        case PVP:  return "PVP";
+        case PVE:  return "PVE";
+        case DEMO: return "DEMO";
+        default:   return "?";
+    }
+}
+
+static void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n";
+    std::cout << "Options:\n";
+    std::cout << "  -h | --help            Print this help message and exit.\n";
+    std::cout << "  --shm=<name>           Shared-memory segment to watch. (Default: " << SHARED_STATE_DEFAULT_NAME << ")\n";
+    std::cout << "  --interval=<ms>        Time between polls. (Default: 1000)\n";
+    std::cout << "  --list                 Also print one line per running match.\n";
+    std::cout << "  --once                 Poll once and exit.\n";
+}
+
+static void poll(const SharedStateMap& map, std::vector<SlotHistory>& history, bool list, Totals& totals) {
+    MatchStatus status;
+    for (int i = 0; i < SHARED_STATE_SLOTS; i++) {
+        if (map.get()->slots[i].owner_pid.load(std::memory_order_acquire) == 0) continue;
+        if (!map.readSlot(i, status)) {
+            totals.unreadable++;
+            continue;
+        }
+        if (status.state == MATCH_FREE) continue;
+
+        SlotHistory& seen = history[i];
+        if (seen.pid == status.pid && status.turn >= seen.turn) totals.advanced_turns += status.turn - seen.turn;
+        else totals.advanced_turns += status.turn;
+        seen.pid = status.pid;
+        seen.turn = status.turn;
+
+        if (status.state == MATCH_FINISHED) {
+            totals.finished++;
+            if (status.result == TANK_A_WIN) totals.wins_a++;
+            else if (status.result == TANK_B_WIN) totals.wins_b++;
+            else if (status.result == DRAW) totals.draws++;
+            continue;
+        }
+        if (!isAlive(status.pid)) {
+            totals.orphaned++;
+            continue;
+        }
+
+        totals.running++;
+        if (status.mode >= 0 && status.mode < 3) totals.by_mode[status.mode]++;
+        totals.turns += status.turn;
+        totals.bullets += status.bullet_count;
+        if (list) {
+            std::cout << "  slot " << std::setw(4) << i << "  pid " << std::setw(7) << status.pid
+                      << "  " << std::setw(4) << modeName(status.mode)
+                      << "  turn " << std::setw(4) << status.turn
+                      << "  map " << std::setw(2) << status.map_size
+                      << "  A " << status.tank_life[0] << "@(" << status.tank_x[0] << "," << status.tank_y[0] << ")"
+                      << "  B " << status.tank_life[1] << "@(" << status.tank_x[1] << "," << status.tank_y[1] << ")"
+                      << "  bullets " << status.bullet_count << "\n";
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string name = SHARED_STATE_DEFAULT_NAME;
+    int interval_ms = 1000;
+    bool list = false;
+    bool once = false;
+
+    static struct option long_options[] = {
+        {"help", no_argument, 0, 'h'},
+        {"shm", required_argument, 0, 's'},
+        {"interval", required_argument, 0, 'i'},
+        {"list", no_argument, 0, 'l'},
+        {"once", no_argument, 0, 'o'},
+        {0, 0, 0, 0}
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "h", long_options, nullptr)) != -1) {
+        switch (opt) {
+            case 'h': printUsage(argv[0]); return 0;
+            case 's': name = optarg; break;
+            case 'i':
+                interval_ms = std::atoi(optarg);
+                if (interval_ms <= 0) {
+                    std::cerr << "Error: Invalid interval: " << optarg << std::endl;
+                    return 1;
+                }
+                break;
+            case 'l': list = true; break;
+            case 'o': once = true; break;
+            default: printUsage(argv[0]); return 1;
+        }
+    }
+
+    SharedStateMap map;
+    if (!map.open(name, false)) {
+        std::cerr << "Error: Cannot open shared state " << name << " (no game has published yet?)" << std::endl;
+        return 1;
+    }
+
+    std::vector<SlotHistory> history(SHARED_STATE_SLOTS);
+    bool first = true;
+    for (;;) {
+        Totals totals;
+        char clock[16];
+        std::time_t now = std::time(nullptr);
+        std::strftime(clock, sizeof(clock), "%H:%M:%S", std::localtime(&now));
+        std::cout << "[" << clock << "] ";
+        if (list) std::cout << "\n";
+        poll(map, history, list, totals);
+
+        if (list) std::cout << "  ";
+        std::cout << "running " << totals.running
+                  << " (PVP " << totals.by_mode[PVP] << ", PVE " << totals.by_mode[PVE]
+                  << ", DEMO " << totals.by_mode[DEMO] << ")"
+                  << ", finished " << totals.finished
+                  << " (A " << totals.wins_a << ", B " << totals.wins_b << ", draw " << totals.draws << ")"
+                  << ", orphaned " << totals.orphaned;
+        if (totals.running > 0) {
+            std::cout << ", avg turn " << totals.turns / totals.running << ", avg bullets "
+                      << std::fixed << std::setprecision(1)
+                      << static_cast<double>(totals.bullets) / totals.running;
+        }
+        if (!first) {
+            std::cout << ", " << std::fixed << std::setprecision(0)
+                      << totals.advanced_turns * 1000.0 / interval_ms << " turns/s";
+        }
+        if (totals.unreadable > 0) std::cout << ", " << totals.unreadable << " busy";
+        std::cout << std::endl;
+
+        if (once) break;
+        first = false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+    }
+    return 0;
+}
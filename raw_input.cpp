@@ -0,0 +1,216 @@
+// raw_input.cpp
+
+#include "raw_input.h"
+#include <sstream>
+#include <cstdlib>
+
+#ifndef _WIN32
+#include <termios.h>
+#include <unistd.h>
+#include <poll.h>
+#include <csignal>
+
+// what the handlers need lives outside the object so they stay async-signal-safe
+static struct termios saved_termios;
+static volatile sig_atomic_t terminal_raw = 0;
+static const int restore_signals[4] = {SIGINT, SIGTERM, SIGHUP, SIGQUIT};
+static struct sigaction previous_actions[4];
+
+static void restoreTerminal() {
+    if (terminal_raw) {
+        tcsetattr(STDIN_FILENO, TCSAFLUSH, &saved_termios);
+        terminal_raw = 0;
+    }
+}
+
+// put the terminal back, then let the previous owner of the signal (the
+// checkpoint writer, or the default action) deal with it
+static void handleRestoreSignal(int signal_number) {
+    restoreTerminal();
+    for (int i = 0; i < 4; i++) {
+        if (restore_signals[i] != signal_number) continue;
+        if (previous_actions[i].sa_handler == SIG_IGN) return;
+        if (previous_actions[i].sa_handler != SIG_DFL) {
+            previous_actions[i].sa_handler(signal_number);
+            return;
+        }
+    }
+    signal(signal_number, SIG_DFL);
+    raise(signal_number);
+}
+#endif
+
+RawInput::RawInput(int move_timeout_ms)
+    : enabled(false), input_closed(false), timeout_ms(move_timeout_ms) {
+}
+
+RawInput::~RawInput() {
+    restore();
+}
+
+bool RawInput::enable() {
+#ifndef _WIN32
+    if (enabled) return true;
+    if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &saved_termios) != 0) return false;
+
+    struct termios raw = saved_termios;
+    raw.c_lflag &= ~(ICANON | ECHO); // keep ISIG so Ctrl-C still interrupts
+    raw.c_iflag &= ~(IXON | ICRNL);
+    raw.c_cc[VMIN] = 0;
+    raw.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw) != 0) return false;
+    terminal_raw = 1;
+
+    static bool hooks_installed = false;
+    if (!hooks_installed) {
+        std::atexit(restoreTerminal);
+        for (int i = 0; i < 4; i++) {
+            struct sigaction action;
+            action.sa_handler = handleRestoreSignal;
+            sigemptyset(&action.sa_mask);
+            action.sa_flags = 0;
+            sigaction(restore_signals[i], &action, &previous_actions[i]);
+        }
+        hooks_installed = true;
+    }
+
+    enabled = true;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void RawInput::restore() {
+#ifndef _WIN32
+    restoreTerminal();
+#endif
+    enabled = false;
+}
+
+Move RawInput::waitForMove(char tank_id) {
+    int index = (tank_id == 'A') ? 0 : 1;
+    Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+
+    // pick up keys that are already waiting in the terminal before deciding
+    // whether this move was typed ahead
+    pump(0);
+    bool buffered = !queues[index].empty();
+
+    while (queues[index].empty()) {
+        if (input_closed) return M_Forward;
+
+        int wait_ms = -1;
+        if (timeout_ms > 0) {
+            wait_ms = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - Clock::now()).count());
+            if (wait_ms <= 0) {
+                latency.timeouts++;
+                return M_Forward;
+            }
+        }
+        pump(wait_ms);
+    }
+
+    KeyPress key = queues[index].front();
+    queues[index].pop_front();
+
+    if (buffered) {
+        latency.buffered_keys++;
+    } else {
+        latency.live_keys++;
+        latency.to_move_us += std::chrono::duration_cast<std::chrono::microseconds>(
+            Clock::now() - key.arrived).count();
+        unshown.push_back(key.arrived);
+    }
+    return key.move;
+}
+
+void RawInput::noteFrameShown() {
+    Clock::time_point now = Clock::now();
+    for (const Clock::time_point& arrived : unshown) {
+        int64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - arrived).count();
+        latency.to_frame_us += elapsed;
+        if (elapsed > latency.max_to_frame_us) latency.max_to_frame_us = elapsed;
+    }
+    unshown.clear();
+}
+
+bool RawInput::pump(int wait_ms) {
+#ifndef _WIN32
+    struct pollfd descriptor;
+    descriptor.fd = STDIN_FILENO;
+    descriptor.events = POLLIN;
+    descriptor.revents = 0;
+
+    int ready = poll(&descriptor, 1, wait_ms);
+    if (ready <= 0) return false;
+
+    Clock::time_point arrived = Clock::now();
+    char bytes[64];
+    ssize_t count = read(STDIN_FILENO, bytes, sizeof(bytes));
+    if (count <= 0) {
+        // with VMIN 0 a readable descriptor that yields nothing is end of input
+        if (count == 0 || (descriptor.revents & POLLHUP)) input_closed = true;
+        return false;
+    }
+    pending_bytes.append(bytes, static_cast<size_t>(count));
+    parseBytes(arrived);
+    return true;
+#else
+    (void)wait_ms;
+    input_closed = true;
+    return false;
+#endif
+}
+
+void RawInput::parseBytes(Clock::time_point arrived) {
+    size_t i = 0;
+    while (i < pending_bytes.size()) {
+        char c = pending_bytes[i];
+        if (c == '\033') {
+            if (i + 2 >= pending_bytes.size()) break; // rest of the sequence is still on its way
+            char kind = pending_bytes[i + 1];
+            char code = pending_bytes[i + 2];
+            if (kind == '[' || kind == 'O') {
+                if (code == 'A') pushKey(1, M_Forward, arrived);
+                else if (code == 'D') pushKey(1, M_Left, arrived);
+                else if (code == 'C') pushKey(1, M_Right, arrived);
+                i += 3;
+            } else {
+                i += 1; // a lone escape
+            }
+            continue;
+        }
+
+        switch (c) {
+            case 'w': case 'W': pushKey(0, M_Forward, arrived); break;
+            case 'a': case 'A': pushKey(0, M_Left, arrived); break;
+            case 'd': case 'D': pushKey(0, M_Right, arrived); break;
+            case 4: input_closed = true; break; // Ctrl-D
+            default: break;
+        }
+        i++;
+    }
+    pending_bytes.erase(0, i);
+}
+
+void RawInput::pushKey(int tank_index, Move move, Clock::time_point arrived) {
+    if (static_cast<int>(queues[tank_index].size()) >= RAW_INPUT_QUEUE_LIMIT) return;
+    KeyPress key;
+    key.move = move;
+    key.arrived = arrived;
+    queues[tank_index].push_back(key);
+}
+
+std::string RawInput::getSummary() const {
+    std::stringstream ss;
+    ss << "Input: " << latency.live_keys << " live keys, " << latency.buffered_keys
+       << " typed ahead, " << latency.timeouts << " timeouts";
+    if (latency.live_keys > 0) {
+        ss << "; key to move " << latency.to_move_us / latency.live_keys << " us"
+           << ", key to frame " << latency.to_frame_us / latency.live_keys << " us avg, "
+           << latency.max_to_frame_us << " us max";
+    }
+    return ss.str();
+}
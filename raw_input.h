@@ -0,0 +1,77 @@
+// raw_input.h
+
+#ifndef RAW_INPUT_H
+#define RAW_INPUT_H
+
+#include <deque>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include "common.h"
+
+// keys a player may press ahead of their turn; more are dropped
+const int RAW_INPUT_QUEUE_LIMIT = 4;
+
+struct InputLatency {
+    int live_keys;        // pressed while the game was waiting for them
+    int buffered_keys;    // pressed ahead and used on a later turn
+    int timeouts;
+    int64_t to_move_us;   // key read -> move handed to the game, live keys only
+    int64_t to_frame_us;  // key read -> next frame written, live keys only
+    int64_t max_to_frame_us;
+
+    InputLatency() : live_keys(0), buffered_keys(0), timeouts(0),
+                     to_move_us(0), to_frame_us(0), max_to_frame_us(0) {}
+};
+
+// Single-keystroke input for two players on one keyboard (--raw-input):
+//   tank A: W forward, A turn left, D turn right
+//   tank B: Up forward, Left turn left, Right turn right
+// The terminal is switched out of canonical mode so keys arrive without Enter;
+// it is restored on exit, on destruction and on SIGINT/SIGTERM/SIGHUP/SIGQUIT.
+class RawInput {
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct KeyPress {
+        Move move;
+        Clock::time_point arrived;
+    };
+
+    std::deque<KeyPress> queues[2]; // per tank, keys not used yet
+    std::string pending_bytes;      // an escape sequence split across reads
+    bool enabled;
+    bool input_closed;
+    int timeout_ms; // <= 0: wait for a key forever
+
+    std::deque<Clock::time_point> unshown; // live keys whose move is not on screen yet
+    InputLatency latency;
+
+public:
+    explicit RawInput(int move_timeout_ms = 0);
+    ~RawInput();
+
+    RawInput(const RawInput&) = delete;
+    RawInput& operator=(const RawInput&) = delete;
+
+    // fails when stdin is not a terminal
+    bool enable();
+    void restore();
+    bool isEnabled() const { return enabled; }
+
+    // next move for the tank; M_Forward when the timeout passes or input is closed
+    Move waitForMove(char tank_id);
+    // called once the turn that used the last moves has been drawn
+    void noteFrameShown();
+
+    const InputLatency& getLatency() const { return latency; }
+    std::string getSummary() const;
+
+private:
+    // reads whatever is available within timeout_ms; false on timeout
+    bool pump(int wait_ms);
+    void parseBytes(Clock::time_point arrived);
+    void pushKey(int tank_index, Move move, Clock::time_point arrived);
+};
+
+#endif // RAW_INPUT_H
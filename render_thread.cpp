@@ -0,0 +1,73 @@
+// render_thread.cpp
+
+#include "render_thread.h"
+#include "ui_manager.h"
+#include "tui_renderer.h"
+#include <chrono>
+
+RenderThread::RenderThread(const UIManager& ui, TuiRenderer* tui, int frames_per_second)
+    : ui_manager(ui), tui_renderer(tui), fps(frames_per_second),
+      published(0), stopping(false), drawn(0), frames_drawn(0), turns_skipped(0) {
+}
+
+RenderThread::~RenderThread() {
+    stop();
+}
+
+void RenderThread::start() {
+    if (worker.joinable()) return;
+    stopping = false;
+    worker = std::thread(&RenderThread::run, this);
+}
+
+void RenderThread::publish(const GameSnapshot& snapshot) {
+    std::lock_guard<std::mutex> lock(mutex);
+    latest = snapshot;
+    published++;
+}
+
+void RenderThread::stop() {
+    if (!worker.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void RenderThread::run() {
+    typedef std::chrono::steady_clock Clock;
+    const Clock::duration period = std::chrono::microseconds(1000000 / fps);
+    Clock::time_point next_frame = Clock::now();
+
+    for (;;) {
+        bool fresh = false;
+        bool last = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait_until(lock, next_frame, [this] { return stopping; });
+            if (published != drawn) {
+                drawing = latest; // copy out so the game is never blocked on the terminal
+                turns_skipped += published - drawn - 1;
+                drawn = published;
+                fresh = true;
+            }
+            last = stopping;
+        }
+
+        if (fresh) draw();
+        if (last) break;
+
+        // a frame that ran late starts the next period now instead of catching up in a burst
+        next_frame += period;
+        Clock::time_point now = Clock::now();
+        if (next_frame < now) next_frame = now;
+    }
+}
+
+void RenderThread::draw() {
+    if (tui_renderer) tui_renderer->render(drawing);
+    else ui_manager.printMapFrame(drawing);
+    frames_drawn++;
+}
@@ -0,0 +1,58 @@
+// render_thread.h
+
+#ifndef RENDER_THREAD_H
+#define RENDER_THREAD_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include "game_snapshot.h"
+
+class UIManager;
+class TuiRenderer;
+
+// Draws the board on its own thread at a fixed frame rate (--fps). The game
+// publishes a snapshot at the end of every turn and carries on; each frame
+// takes whatever was published last, so turns in between are never drawn
+// and a slow terminal no longer holds up the simulation.
+class RenderThread {
+private:
+    const UIManager& ui_manager;
+    TuiRenderer* tui_renderer; // null: plain frames
+    int fps;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    GameSnapshot latest;  // guarded by mutex
+    uint64_t published;   // guarded by mutex
+    bool stopping;        // guarded by mutex
+
+    GameSnapshot drawing; // render thread only
+    uint64_t drawn;
+    int frames_drawn;
+    uint64_t turns_skipped;
+    std::thread worker;
+
+public:
+    RenderThread(const UIManager& ui, TuiRenderer* tui, int frames_per_second);
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    void start();
+    void publish(const GameSnapshot& snapshot);
+    // draws the last published state if it has not been shown yet, then joins
+    void stop();
+
+    // only meaningful after stop()
+    int getFramesDrawn() const { return frames_drawn; }
+    uint64_t getTurnsSkipped() const { return turns_skipped; }
+
+private:
+    void run();
+    void draw();
+};
+
+#endif // RENDER_THREAD_H
@@ -0,0 +1,210 @@
+// replay.cpp
+
+#include "replay.h"
+#include "binary_io.h"
+
+static const char REPLAY_MAGIC[4] = {'T', 'W', 'R', 'P'};
+static const char INDEX_MAGIC[4] = {'T', 'W', 'R', 'I'};
+
+uint16_t foldStateHash(uint64_t hash) {
+    return static_cast<uint16_t>(hash ^ (hash >> 16) ^ (hash >> 32) ^ (hash >> 48));
+}
+
+ReplayRecorder::ReplayRecorder() : turns_recorded(0) {}
+
+ReplayRecorder::~ReplayRecorder() {
+    close();
+}
+
+bool ReplayRecorder::open(const std::string& file_name, const ReplayHeader& header) {
+    close();
+
+    filename = file_name;
+    turns_recorded = 0;
+    keyframe_data.clear();
+    keyframe_index.clear();
+    file.open(file_name, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+
+    std::vector<uint8_t> buffer(REPLAY_HEADER_SIZE, 0);
+    for (int i = 0; i < 4; i++) buffer[i] = static_cast<uint8_t>(REPLAY_MAGIC[i]);
+    buffer[4] = static_cast<uint8_t>(REPLAY_VERSION);
+    buffer[5] = static_cast<uint8_t>(header.mode);
+    buffer[6] = static_cast<uint8_t>(header.initial_life_points);
+    buffer[8] = static_cast<uint8_t>(static_cast<int8_t>(header.tank_a_x));
+    buffer[9] = static_cast<uint8_t>(static_cast<int8_t>(header.tank_a_y));
+    buffer[10] = static_cast<uint8_t>(header.tank_a_dir);
+    buffer[11] = static_cast<uint8_t>(static_cast<int8_t>(header.tank_b_x));
+    buffer[12] = static_cast<uint8_t>(static_cast<int8_t>(header.tank_b_y));
+    buffer[13] = static_cast<uint8_t>(header.tank_b_dir);
+    buffer.resize(16);
+    appendU64(buffer, header.rng_seed);
+
+    file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    return file.good();
+}
+
+void ReplayRecorder::recordTurn(Move move_a, Move move_b, uint16_t state_hash) {
+    if (!file.is_open()) return;
+
+    uint8_t record[REPLAY_TURN_SIZE];
+    record[0] = static_cast<uint8_t>((move_a & 0x3) | ((move_b & 0x3) << 2));
+    record[1] = static_cast<uint8_t>(state_hash);
+    record[2] = static_cast<uint8_t>(state_hash >> 8);
+    file.write(reinterpret_cast<const char*>(record), sizeof(record));
+    turns_recorded++;
+}
+
+void ReplayRecorder::recordKeyframe(const GameSnapshot& snapshot) {
+    if (!file.is_open()) return;
+
+    // offset is relative to the start of the keyframe section until finish()
+    keyframe_index.emplace_back(snapshot.current_turn, keyframe_data.size());
+    encodeSnapshot(snapshot, keyframe_data);
+}
+
+void ReplayRecorder::finish(GameResult result) {
+    if (!file.is_open()) return;
+
+    uint64_t keyframe_offset = REPLAY_HEADER_SIZE +
+                               static_cast<uint64_t>(turns_recorded) * REPLAY_TURN_SIZE;
+    uint64_t index_offset = keyframe_offset + keyframe_data.size();
+
+    std::vector<uint8_t> trailer;
+    trailer.reserve(keyframe_index.size() * REPLAY_INDEX_ENTRY_SIZE + REPLAY_FOOTER_SIZE);
+    for (const auto& entry : keyframe_index) {
+        appendU32(trailer, static_cast<uint32_t>(entry.first));
+        appendU64(trailer, keyframe_offset + entry.second);
+    }
+    appendU64(trailer, index_offset);
+    appendU32(trailer, static_cast<uint32_t>(keyframe_index.size()));
+    appendU32(trailer, static_cast<uint32_t>(turns_recorded));
+    appendU8(trailer, static_cast<uint8_t>(result));
+    appendU8(trailer, 0);
+    appendU16(trailer, 0);
+    for (int i = 0; i < 4; i++) appendU8(trailer, static_cast<uint8_t>(INDEX_MAGIC[i]));
+
+    file.write(reinterpret_cast<const char*>(keyframe_data.data()), keyframe_data.size());
+    file.write(reinterpret_cast<const char*>(trailer.data()), trailer.size());
+    close();
+}
+
+void ReplayRecorder::close() {
+    if (file.is_open()) {
+        file.close();
+    }
+}
+
+ReplayReader::ReplayReader()
+    : data(nullptr), data_size(0), turn_count(0), keyframe_count(0),
+      index_offset(0), recorded_result(GAME_CONTINUE) {}
+
+ReplayReader::~ReplayReader() {
+    close();
+}
+
+bool ReplayReader::open(const std::string& file_name) {
+    close();
+    filename = file_name;
+
+    if (!mapped.open(file_name)) return false;
+    data = mapped.getData();
+    data_size = mapped.getSize();
+    if (!parseHeader()) {
+        close();
+        return false;
+    }
+    parseFooter();
+    return true;
+}
+
+void ReplayReader::close() {
+    mapped.close();
+    data = nullptr;
+    data_size = 0;
+    turn_count = 0;
+    keyframe_count = 0;
+    index_offset = 0;
+    recorded_result = GAME_CONTINUE;
+}
+
+bool ReplayReader::parseHeader() {
+    if (data_size < static_cast<size_t>(REPLAY_HEADER_SIZE)) return false;
+
+    for (int i = 0; i < 4; i++) {
+        if (data[i] != static_cast<uint8_t>(REPLAY_MAGIC[i])) return false;
+    }
+    if (data[4] < 1 || data[4] > REPLAY_VERSION) return false;
+    if (data[5] > DEMO || data[10] > D_Down || data[13] > D_Down) return false;
+
+    header.mode = static_cast<GameMode>(data[5]);
+    header.initial_life_points = data[6];
+    header.tank_a_x = static_cast<int8_t>(data[8]);
+    header.tank_a_y = static_cast<int8_t>(data[9]);
+    header.tank_a_dir = static_cast<Direction>(data[10]);
+    header.tank_b_x = static_cast<int8_t>(data[11]);
+    header.tank_b_y = static_cast<int8_t>(data[12]);
+    header.tank_b_dir = static_cast<Direction>(data[13]);
+    header.rng_seed = readU64(data + 16);
+
+    // without a footer every byte after the header is a turn record;
+    // a truncated trailing record is dropped
+    turn_count = static_cast<int>((data_size - REPLAY_HEADER_SIZE) / REPLAY_TURN_SIZE);
+    return true;
+}
+
+void ReplayReader::parseFooter() {
+    if (data[4] < 2) return;
+    if (data_size < static_cast<size_t>(REPLAY_HEADER_SIZE + REPLAY_FOOTER_SIZE)) return;
+
+    const uint8_t* footer = data + data_size - REPLAY_FOOTER_SIZE;
+    for (int i = 0; i < 4; i++) {
+        if (footer[20 + i] != static_cast<uint8_t>(INDEX_MAGIC[i])) return;
+    }
+
+    uint64_t offset = readU64(footer);
+    uint32_t keyframes = readU32(footer + 8);
+    uint32_t turns = readU32(footer + 12);
+    uint8_t result = footer[16];
+
+    uint64_t index_end = offset + static_cast<uint64_t>(keyframes) * REPLAY_INDEX_ENTRY_SIZE;
+    uint64_t turns_end = REPLAY_HEADER_SIZE + static_cast<uint64_t>(turns) * REPLAY_TURN_SIZE;
+    if (index_end != data_size - REPLAY_FOOTER_SIZE || turns_end > offset || result > DRAW) return;
+
+    index_offset = static_cast<size_t>(offset);
+    keyframe_count = static_cast<int>(keyframes);
+    turn_count = static_cast<int>(turns);
+    recorded_result = static_cast<GameResult>(result);
+}
+
+bool ReplayReader::getTurn(int turn, Move& move_a, Move& move_b, uint16_t& state_hash) const {
+    if (turn < 1 || turn > turn_count) return false;
+
+    const uint8_t* record = data + REPLAY_HEADER_SIZE + static_cast<size_t>(turn - 1) * REPLAY_TURN_SIZE;
+    int packed_a = record[0] & 0x3;
+    int packed_b = (record[0] >> 2) & 0x3;
+    if (packed_a > M_Right || packed_b > M_Right) return false;
+
+    move_a = static_cast<Move>(packed_a);
+    move_b = static_cast<Move>(packed_b);
+    state_hash = readU16(record + 1);
+    return true;
+}
+
+bool ReplayReader::findKeyframe(int turn, GameSnapshot& snapshot) const {
+    if (keyframe_count == 0) return false;
+
+    // binary search for the last index entry with entry.turn <= turn
+    const uint8_t* index = data + index_offset;
+    int low = 0, high = keyframe_count;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (static_cast<int>(readU32(index + mid * REPLAY_INDEX_ENTRY_SIZE)) <= turn) low = mid + 1;
+        else high = mid;
+    }
+    if (low == 0) return false;
+
+    uint64_t offset = readU64(index + (low - 1) * REPLAY_INDEX_ENTRY_SIZE + 4);
+    if (offset >= index_offset) return false;
+    return decodeSnapshot(data + offset, index_offset - offset, snapshot) != 0;
+}
@@ -0,0 +1,116 @@
+// replay.h
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include "common.h"
+#include "game_snapshot.h"
+#include "mapped_file.h"
+
+// Replay file layout (little-endian):
+//   header     "TWRP", version, mode, initial life, tank A/B setup, rng seed
+//   turns      3 bytes per turn: moves (A in bits 0-1, B in bits 2-3), 16-bit state hash
+//   keyframes  full GameSnapshot every REPLAY_KEYFRAME_INTERVAL turns        (version 2)
+//   index      (turn, offset) per keyframe, sorted by turn                   (version 2)
+//   footer     index offset, keyframe count, turn count, result, "TWRI"      (version 2)
+// The engine is deterministic, so the moves alone are enough to re-simulate a game;
+// keyframes only make seeking cheap. A file without footer (e.g. the recording
+// process died) is still playable from the start.
+
+const int REPLAY_VERSION = 2;
+const int REPLAY_HEADER_SIZE = 24;
+const int REPLAY_TURN_SIZE = 3;
+const int REPLAY_INDEX_ENTRY_SIZE = 12;
+const int REPLAY_FOOTER_SIZE = 24;
+const int REPLAY_KEYFRAME_INTERVAL = 64;
+
+struct ReplayHeader {
+    GameMode mode;
+    int initial_life_points;
+    int tank_a_x, tank_a_y;
+    Direction tank_a_dir;
+    int tank_b_x, tank_b_y;
+    Direction tank_b_dir;
+    uint64_t rng_seed;
+
+    ReplayHeader() :
+        mode(PVP), initial_life_points(DEFAULT_LIFE_POINTS),
+        tank_a_x(0), tank_a_y(0), tank_a_dir(D_Right),
+        tank_b_x(0), tank_b_y(0), tank_b_dir(D_Left),
+        rng_seed(0) {}
+};
+
+class ReplayRecorder {
+private:
+    std::string filename;
+    std::ofstream file;
+    int turns_recorded;
+
+    // keyframes are kept in memory and written behind the turn records on finish()
+    std::vector<uint8_t> keyframe_data;
+    std::vector<std::pair<int, uint64_t>> keyframe_index;
+
+public:
+    ReplayRecorder();
+    ~ReplayRecorder();
+
+    bool open(const std::string& file_name, const ReplayHeader& header);
+    void recordTurn(Move move_a, Move move_b, uint16_t state_hash);
+    void recordKeyframe(const GameSnapshot& snapshot);
+    void finish(GameResult result);
+    void close();
+
+    bool isOpen() const { return file.is_open(); }
+    int getTurnsRecorded() const { return turns_recorded; }
+    std::string getFilename() const { return filename; }
+};
+
+class ReplayReader {
+private:
+    std::string filename;
+    ReplayHeader header;
+
+    // the whole file is mapped read-only
+    MappedFile mapped;
+    const uint8_t* data;
+    size_t data_size;
+
+    int turn_count;
+    int keyframe_count;
+    size_t index_offset;
+    GameResult recorded_result;
+
+public:
+    ReplayReader();
+    ~ReplayReader();
+
+    ReplayReader(const ReplayReader&) = delete;
+    ReplayReader& operator=(const ReplayReader&) = delete;
+
+    bool open(const std::string& file_name);
+    void close();
+
+    const ReplayHeader& getHeader() const { return header; }
+    int getTurnCount() const { return turn_count; }
+    int getKeyframeCount() const { return keyframe_count; }
+    GameResult getRecordedResult() const { return recorded_result; }
+    std::string getFilename() const { return filename; }
+
+    // turn is 1-based, as in GameEngine::getCurrentTurn()
+    bool getTurn(int turn, Move& move_a, Move& move_b, uint16_t& state_hash) const;
+
+    // latest keyframe at or before turn; false if the file has no usable keyframe
+    bool findKeyframe(int turn, GameSnapshot& snapshot) const;
+
+private:
+    bool parseHeader();
+    void parseFooter();
+};
+
+uint16_t foldStateHash(uint64_t hash);
+
+#endif // REPLAY_H
@@ -0,0 +1,184 @@
+// route_planner.cpp
+
+#include "route_planner.h"
+#include "ai_player.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+static const int DX[4] = {-1, 0, 1, 0}; // by Direction: left, up, right, down
+static const int DY[4] = {0, -1, 0, 1};
+
+RoutePlanner::RoutePlanner()
+    : nodes(MAX_NODES), seen((HORIZON + 1) * INITIAL_MAP_SIZE * INITIAL_MAP_SIZE * 4, 0), generation(0),
+      last_expansions(0), last_length(0), plans(0), routes(0), total_expansions(0), total_seconds(0) {
+}
+
+RoutePlanner::RoutePlanner(const RoutePlanner& other) : RoutePlanner() {
+    *this = other;
+}
+
+RoutePlanner& RoutePlanner::operator=(const RoutePlanner& other) {
+    last_expansions = other.last_expansions;
+    last_length = other.last_length;
+    plans = other.plans;
+    routes = other.routes;
+    total_expansions = other.total_expansions;
+    total_seconds = other.total_seconds;
+    return *this;
+}
+
+bool RoutePlanner::planToFiringLine(const AIState& state, Move& first_move) {
+    return plan(state, Goal(GOAL_FIRING_LINE, state.enemy_pos.x, state.enemy_pos.y), first_move);
+}
+
+bool RoutePlanner::planToCenter(const AIState& state, Move& first_move) {
+    return plan(state, Goal(GOAL_CENTER, state.center_x, state.center_y), first_move);
+}
+
+bool RoutePlanner::plan(const AIState& state, const Goal& goal, Move& first_move) {
+    last_expansions = 0;
+    last_length = 0;
+    // a tank off the map is already taking damage, and its cells are not in the tables
+    const MapBounds& bounds = state.current_bounds;
+    if (state.my_pos.x < bounds.min_x || state.my_pos.x > bounds.max_x ||
+        state.my_pos.y < bounds.min_y || state.my_pos.y > bounds.max_y) return false;
+    if (goal.type == GOAL_FIRING_LINE && !isOnBoard(goal.x, goal.y)) return false;
+    if (isGoal(goal, state.my_pos.x, state.my_pos.y, state.my_dir)) return false;
+
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+
+    bool found = search(state, goal, first_move);
+
+    plans++;
+    if (found) routes++;
+    total_expansions += last_expansions;
+    total_seconds += std::chrono::duration<double>(Clock::now() - start).count();
+    return found;
+}
+
+bool RoutePlanner::search(const AIState& state, const Goal& goal, Move& first_move) {
+    nextGeneration();
+    predictBounds(state);
+    std::fill(heads, heads + BUCKETS, -1);
+    int node_count = 0;
+
+    int lowest = heuristic(goal, state.my_pos.x, state.my_pos.y, state.my_dir);
+    if (lowest > HORIZON) return false;
+    Node& root = nodes[node_count];
+    root.x = static_cast<int8_t>(state.my_pos.x);
+    root.y = static_cast<int8_t>(state.my_pos.y);
+    root.dir = static_cast<uint8_t>(state.my_dir);
+    root.turn = 0;
+    root.first_move = M_Forward;
+    root.next = heads[lowest];
+    heads[lowest] = node_count++;
+
+    while (last_expansions < MAX_EXPANSIONS) {
+        // f never decreases with a consistent heuristic, so the lowest bucket only moves up
+        while (lowest < BUCKETS && heads[lowest] < 0) lowest++;
+        if (lowest == BUCKETS) return false;
+
+        // last in, first out: in the same bucket the deepest node is nearest the goal
+        const Node node = nodes[heads[lowest]];
+        heads[lowest] = node.next;
+
+        if (node.turn > 0 && isGoal(goal, node.x, node.y, node.dir)) {
+            first_move = static_cast<Move>(node.first_move);
+            last_length = node.turn;
+            return true;
+        }
+        if (node.turn == HORIZON) continue;
+        last_expansions++;
+
+        int turn = node.turn + 1;
+        for (int m = 0; m < 3; m++) {
+            Move move = static_cast<Move>(m);
+            int dir = node.dir;
+            if (move == M_Left) dir = turnLeft(static_cast<Direction>(dir));
+            else if (move == M_Right) dir = turnRight(static_cast<Direction>(dir));
+            int x = node.x + ((move == M_Forward) ? DX[dir] * TANK_SPEED : 0);
+            int y = node.y + ((move == M_Forward) ? DY[dir] * TANK_SPEED : 0);
+
+            // out-of-map damage is dealt at the end of the turn, on that turn's map
+            if (x < min_bound[turn] || x > max_bound[turn] || y < min_bound[turn] || y > max_bound[turn]) continue;
+            if (x == state.enemy_pos.x && y == state.enemy_pos.y) continue;
+            if (turn <= DangerMap::HORIZON && state.danger.isHitOnTurn(turn, x, y)) continue;
+
+            // the heuristic never overestimates: past the horizon there is no route
+            int f = turn + heuristic(goal, x, y, dir);
+            if (f > HORIZON) continue;
+
+            uint32_t& mark = seen[((turn * INITIAL_MAP_SIZE + y) * INITIAL_MAP_SIZE + x) * 4 + dir];
+            if (mark == generation) continue;
+            mark = generation;
+
+            Node& child = nodes[node_count];
+            child.x = static_cast<int8_t>(x);
+            child.y = static_cast<int8_t>(y);
+            child.dir = static_cast<uint8_t>(dir);
+            child.turn = static_cast<uint8_t>(turn);
+            child.first_move = static_cast<uint8_t>(node.turn == 0 ? m : node.first_move);
+            child.next = heads[f];
+            heads[f] = node_count++;
+        }
+    }
+    return false;
+}
+
+void RoutePlanner::nextGeneration() {
+    if (++generation == 0) {
+        std::fill(seen.begin(), seen.end(), 0);
+        generation = 1;
+    }
+}
+
+// the shrink schedule of AIPlayer::predictFutureBounds, one entry per turn ahead;
+// turn 1 is the one being decided, whose shrink has already happened
+void RoutePlanner::predictBounds(const AIState& state) {
+    int size = state.map_size;
+    for (int t = 1; t <= HORIZON; t++) {
+        if (t > 1 && (state.turn_count + t - 1) % state.shrink_interval == 0 && size > 2) size -= 2;
+        int half_size = size / 2;
+        min_bound[t] = std::max(state.center_x - half_size, 0);
+        max_bound[t] = std::min(state.center_x + half_size - 1, INITIAL_MAP_SIZE - 1);
+    }
+}
+
+// turns still needed, never overestimated. Changes by at most one per move, so
+// it is consistent.
+int RoutePlanner::heuristic(const Goal& goal, int x, int y, int dir) {
+    if (goal.type == GOAL_CENTER) {
+        // one move per cell outside the central square
+        int dx = std::max(std::max(goal.x - 1 - x, x - goal.x), 0);
+        int dy = std::max(std::max(goal.y - 1 - y, y - goal.y), 0);
+        return dx + dy;
+    }
+
+    // facing the target along a column or a row: one move per cell of offset
+    // across the line, plus at least one turn to face along it
+    int target_x = goal.x, target_y = goal.y;
+    int along_column = std::abs(x - target_x);
+    Direction column_dir = (target_y < y) ? D_Up : D_Down;
+    along_column += (along_column > 0 || dir != column_dir) ? 1 : 0;
+
+    int along_row = std::abs(y - target_y);
+    Direction row_dir = (target_x < x) ? D_Left : D_Right;
+    along_row += (along_row > 0 || dir != row_dir) ? 1 : 0;
+
+    return std::min(along_column, along_row);
+}
+
+bool RoutePlanner::isOnBoard(int x, int y) {
+    return x >= 0 && x < INITIAL_MAP_SIZE && y >= 0 && y < INITIAL_MAP_SIZE;
+}
+
+bool RoutePlanner::isGoal(const Goal& goal, int x, int y, int dir) {
+    if (goal.type == GOAL_CENTER) {
+        return x >= goal.x - 1 && x <= goal.x && y >= goal.y - 1 && y <= goal.y;
+    }
+    int dx = goal.x - x, dy = goal.y - y;
+    int range = (dy == 0) ? dx * DX[dir] : (dx == 0) ? dy * DY[dir] : 0;
+    return range >= FIRING_RANGE && (range - FIRING_RANGE) % BULLET_SPEED == 0;
+}
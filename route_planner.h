@@ -0,0 +1,89 @@
+// route_planner.h
+
+#ifndef ROUTE_PLANNER_H
+#define ROUTE_PLANNER_H
+
+#include <vector>
+#include <cstdint>
+#include "common.h"
+
+struct AIState;
+
+// Shortest safe route to a firing line on the enemy, found with A* over
+// (x, y, direction, turn). The turn is part of the state because what is safe
+// changes every turn: bullets land on other cells and the map shrinks on
+// schedule. Every move takes one turn, turning in place included, so the turn
+// is also the cost of the route and no state is reached twice; the table of
+// states seen is stamped with a generation and never cleared between plans.
+class RoutePlanner {
+public:
+    static const int HORIZON = 24;          // longest route looked for, in turns
+    static const int MAX_EXPANSIONS = 512;  // per plan, keeps it in the microseconds
+    // the nearest cell a bullet hits: it spawns this far ahead and flies the same turn
+    static const int FIRING_RANGE = BULLET_SPAWN_DISTANCE + BULLET_SPEED;
+
+private:
+    enum GoalType { GOAL_FIRING_LINE, GOAL_CENTER };
+    struct Goal {
+        GoalType type;
+        int x, y; // the enemy, or the center of the map
+        Goal(GoalType type, int x, int y) : type(type), x(x), y(y) {}
+    };
+    struct Node {
+        int8_t x, y;
+        uint8_t dir, turn;
+        uint8_t first_move;  // of the route that led here
+        int32_t next;        // in the same bucket
+    };
+    static const int MAX_NODES = MAX_EXPANSIONS * 3 + 1;
+    static const int BUCKETS = HORIZON + 1; // by f = turn + heuristic, none past the horizon
+
+    // scratch space, allocated once
+    std::vector<Node> nodes;
+    std::vector<uint32_t> seen; // generation per (turn, y, x, direction)
+    uint32_t generation;
+    int32_t heads[BUCKETS];
+    int min_bound[HORIZON + 1]; // map bounds after each turn, the same on both axes
+    int max_bound[HORIZON + 1];
+
+    // statistics
+    int last_expansions;
+    int last_length;
+    uint64_t plans;
+    uint64_t routes;
+    uint64_t total_expansions;
+    double total_seconds;
+
+public:
+    RoutePlanner();
+    // a copy gets its own scratch space; only the statistics are copied
+    RoutePlanner(const RoutePlanner& other);
+    RoutePlanner& operator=(const RoutePlanner& other);
+
+    // first move of the shortest route to a cell facing the enemy along a row or
+    // column, at least FIRING_RANGE away. The route stays on the shrinking map,
+    // off the cells enemy bullets land on in each turn and off the enemy's cell.
+    // false if the tank is on a firing line already, is off the map, the enemy is
+    // off the board, or no route was found in budget.
+    bool planToFiringLine(const AIState& state, Move& first_move);
+    // the same to one of the four cells in the middle of the map
+    bool planToCenter(const AIState& state, Move& first_move);
+
+    int getLastExpansions() const { return last_expansions; }
+    int getLastLength() const { return last_length; }
+    uint64_t getPlans() const { return plans; }
+    uint64_t getRoutes() const { return routes; }
+    uint64_t getTotalExpansions() const { return total_expansions; }
+    double getTotalSeconds() const { return total_seconds; }
+
+private:
+    bool plan(const AIState& state, const Goal& goal, Move& first_move);
+    bool search(const AIState& state, const Goal& goal, Move& first_move);
+    void nextGeneration();
+    void predictBounds(const AIState& state);
+    static int heuristic(const Goal& goal, int x, int y, int dir);
+    static bool isOnBoard(int x, int y);
+    static bool isGoal(const Goal& goal, int x, int y, int dir);
+};
+
+#endif // ROUTE_PLANNER_H
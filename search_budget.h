@@ -0,0 +1,23 @@
+// search_budget.h
+
+#ifndef SEARCH_BUDGET_H
+#define SEARCH_BUDGET_H
+
+const int DEFAULT_SEARCH_PLAYOUTS = 3000;
+const int DEFAULT_SEARCH_DEPTH = 4;
+const int MAX_SEARCH_DEPTH = 12;
+const int MAX_SEARCH_THREADS = 64;
+
+// how much a searching AI may spend on one move; whichever limit comes first
+struct SearchBudget {
+    int playouts; // iterations (MCTS playouts), 0: no limit
+    int time_ms;  // wall time, 0: no limit
+    int depth;    // turns looked ahead by the minimax search
+    int threads;  // the minimax search splits its root over this many, 1: serial
+
+    SearchBudget(int max_playouts = DEFAULT_SEARCH_PLAYOUTS, int max_time_ms = 0, int max_depth = DEFAULT_SEARCH_DEPTH,
+                 int max_threads = 1)
+        : playouts(max_playouts), time_ms(max_time_ms), depth(max_depth), threads(max_threads) {}
+};
+
+#endif // SEARCH_BUDGET_H
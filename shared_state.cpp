@@ -0,0 +1,160 @@
+// shared_state.cpp
+
+#include "shared_state.h"
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <cerrno>
+#endif
+
+MatchStatus::MatchStatus()
+    : pid(0), state(MATCH_FREE), mode(PVP), result(GAME_CONTINUE), turn(0),
+      map_size(0), bullet_count(0), updated_at(0) {
+    for (int i = 0; i < 2; i++) {
+        tank_x[i] = tank_y[i] = tank_direction[i] = tank_life[i] = 0;
+    }
+}
+
+SharedStateMap::SharedStateMap() : segment(nullptr) {}
+
+SharedStateMap::~SharedStateMap() {
+    close();
+}
+
+bool SharedStateMap::open(const std::string& segment_name, bool create) {
+    close();
+#ifndef _WIN32
+    int fd = shm_open(segment_name.c_str(), create ? (O_CREAT | O_RDWR) : O_RDWR, 0666);
+    if (fd < 0) return false;
+
+    // a fresh segment has size 0; several creators all extend it to the same size
+    struct stat info;
+    if (fstat(fd, &info) != 0 ||
+        (static_cast<size_t>(info.st_size) < sizeof(SharedStateSegment) &&
+         (!create || ftruncate(fd, sizeof(SharedStateSegment)) != 0))) {
+        ::close(fd);
+        return false;
+    }
+
+    void* address = mmap(nullptr, sizeof(SharedStateSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) return false;
+    segment = static_cast<SharedStateSegment*>(address);
+    name = segment_name;
+
+    // the zero-filled segment is already a valid empty table; just stamp it
+    if (create && segment->magic.load(std::memory_order_acquire) == 0) {
+        segment->version = SHARED_STATE_VERSION;
+        segment->slot_count = SHARED_STATE_SLOTS;
+        uint32_t expected = 0;
+        segment->magic.compare_exchange_strong(expected, SHARED_STATE_MAGIC, std::memory_order_release);
+    }
+    if (segment->magic.load(std::memory_order_acquire) != SHARED_STATE_MAGIC ||
+        segment->version != SHARED_STATE_VERSION) {
+        close();
+        return false;
+    }
+    return true;
+#else
+    (void)segment_name;
+    (void)create;
+    return false;
+#endif
+}
+
+void SharedStateMap::close() {
+#ifndef _WIN32
+    if (segment) munmap(segment, sizeof(SharedStateSegment));
+#endif
+    segment = nullptr;
+}
+
+bool SharedStateMap::readSlot(int index, MatchStatus& status) const {
+    const SharedStateSlot& slot = segment->slots[index];
+    uint32_t words[SHARED_STATE_WORDS];
+
+    for (int attempt = 0; attempt < 64; attempt++) {
+        uint32_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before & 1) continue; // writer is in the middle of an update
+        for (int i = 0; i < SHARED_STATE_WORDS; i++) {
+            words[i] = slot.words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == before) {
+            std::memcpy(&status, words, sizeof(status));
+            return true;
+        }
+    }
+    return false;
+}
+
+#ifndef _WIN32
+static bool isProcessGone(int32_t pid) {
+    return pid > 0 && kill(pid, 0) != 0 && errno == ESRCH;
+}
+#endif
+
+SharedStatePublisher::SharedStatePublisher() : slot_index(-1), owner_pid(0) {}
+
+SharedStatePublisher::~SharedStatePublisher() {
+    release();
+}
+
+bool SharedStatePublisher::open(const std::string& segment_name) {
+#ifndef _WIN32
+    if (!map.open(segment_name, true)) return false;
+
+    SharedStateSegment* segment = map.get();
+    owner_pid = static_cast<int32_t>(getpid());
+    MatchStatus status;
+
+    // first pass takes free slots and those of dead processes, the second
+    // recycles finished matches, oldest record first in slot order
+    for (int pass = 0; pass < 2 && slot_index < 0; pass++) {
+        for (int i = 0; i < SHARED_STATE_SLOTS; i++) {
+            SharedStateSlot& slot = segment->slots[i];
+            int32_t owner = slot.owner_pid.load(std::memory_order_acquire);
+            bool usable = (owner == 0) || isProcessGone(owner);
+            if (!usable && pass == 1) {
+                usable = map.readSlot(i, status) && status.state == MATCH_FINISHED;
+            }
+            if (usable && slot.owner_pid.compare_exchange_strong(owner, owner_pid, std::memory_order_acq_rel)) {
+                slot_index = i;
+                break;
+            }
+        }
+    }
+    if (slot_index < 0) {
+        map.close();
+        return false;
+    }
+    return true;
+#else
+    (void)segment_name;
+    return false;
+#endif
+}
+
+void SharedStatePublisher::publish(const MatchStatus& status) {
+    if (slot_index < 0) return;
+    SharedStateSlot& slot = map.get()->slots[slot_index];
+
+    std::memcpy(words, &status, sizeof(words));
+    uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (int i = 0; i < SHARED_STATE_WORDS; i++) {
+        slot.words[i].store(words[i], std::memory_order_relaxed);
+    }
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void SharedStatePublisher::release() {
+    slot_index = -1;
+    map.close();
+}
@@ -0,0 +1,102 @@
+// shared_state.h
+
+#ifndef SHARED_STATE_H
+#define SHARED_STATE_H
+
+#include <atomic>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "common.h"
+
+const char* const SHARED_STATE_DEFAULT_NAME = "/tankwar";
+const uint32_t SHARED_STATE_MAGIC = 0x53575754; // "TWWS"
+const uint32_t SHARED_STATE_VERSION = 1;
+const int SHARED_STATE_SLOTS = 4096;
+
+enum MatchState {
+    MATCH_FREE = 0, MATCH_RUNNING = 1, MATCH_FINISHED = 2
+};
+
+// what a monitor sees of one match, as of the end of its latest turn
+struct MatchStatus {
+    int32_t pid;
+    int32_t state;        // MatchState
+    int32_t mode;         // GameMode
+    int32_t result;       // GameResult
+    int32_t turn;
+    int32_t map_size;
+    int32_t bullet_count;
+    int32_t tank_x[2];
+    int32_t tank_y[2];
+    int32_t tank_direction[2];
+    int32_t tank_life[2];
+    uint32_t updated_at;  // unix seconds
+
+    MatchStatus();
+};
+
+const int SHARED_STATE_WORDS = sizeof(MatchStatus) / sizeof(uint32_t);
+
+// One match per slot, each behind its own seqlock: the single writer bumps the
+// sequence to odd, stores the words and bumps it to even again. Readers copy
+// the words and retry if the sequence was odd or changed, so they never hold
+// up the game. The words are relaxed atomics, which keeps the concurrent
+// access well defined and costs nothing over plain stores on x86 and ARM.
+struct alignas(64) SharedStateSlot {
+    std::atomic<uint32_t> sequence;
+    std::atomic<int32_t> owner_pid; // claimed with a compare-exchange
+    std::atomic<uint32_t> words[SHARED_STATE_WORDS];
+};
+
+struct SharedStateSegment {
+    std::atomic<uint32_t> magic;
+    uint32_t version;
+    uint32_t slot_count;
+    SharedStateSlot slots[SHARED_STATE_SLOTS];
+};
+
+// maps the segment, creating it on first use
+class SharedStateMap {
+private:
+    SharedStateSegment* segment;
+    std::string name;
+
+public:
+    SharedStateMap();
+    ~SharedStateMap();
+
+    SharedStateMap(const SharedStateMap&) = delete;
+    SharedStateMap& operator=(const SharedStateMap&) = delete;
+
+    bool open(const std::string& segment_name, bool create);
+    void close();
+    bool isOpen() const { return segment != nullptr; }
+    const std::string& getName() const { return name; }
+
+    SharedStateSegment* get() const { return segment; }
+    // false if the slot was being written every time it was looked at
+    bool readSlot(int index, MatchStatus& status) const;
+};
+
+// the game side: claims a slot and rewrites it once per turn
+class SharedStatePublisher {
+private:
+    SharedStateMap map;
+    int slot_index;
+    int32_t owner_pid;
+    uint32_t words[SHARED_STATE_WORDS];
+
+public:
+    SharedStatePublisher();
+    ~SharedStatePublisher();
+
+    bool open(const std::string& segment_name);
+    void publish(const MatchStatus& status);
+    // leaves the final record readable; the slot is reused by a later match
+    void release();
+    int getSlotIndex() const { return slot_index; }
+    int32_t getOwnerPid() const { return owner_pid; }
+};
+
+#endif // SHARED_STATE_H
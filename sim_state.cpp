@@ -0,0 +1,150 @@
+// sim_state.cpp
+
+#include "sim_state.h"
+#include "game_core.h"
+#include <cstring>
+#include <cstddef>
+
+static const int DX[4] = {-1, 0, 1, 0}; // by Direction: left, up, right, down
+static const int DY[4] = {0, -1, 0, 1};
+
+void SimState::capture(const GameCore& core, char deciding_id) {
+    const Tank* sources[2] = {&core.getTankA(), &core.getTankB()};
+    for (int i = 0; i < 2; i++) {
+        tanks[i].x = sources[i]->getX();
+        tanks[i].y = sources[i]->getY();
+        tanks[i].direction = sources[i]->getDirection();
+        tanks[i].life_points = sources[i]->getLifePoints();
+        tanks[i].shoot_counter = sources[i]->getShootCounter();
+    }
+    turn = core.getCurrentTurn();
+    map_size = core.getGameMap().getCurrentSize();
+    map_turn_count = core.getGameMap().getTurnCount();
+    turn_started = true;
+    a_moved = (deciding_id == 'B');
+    result = GAME_CONTINUE;
+
+    bullet_count = 0;
+    for (const Bullet& bullet : core.getBullets()) {
+        if (!bullet.isActive() || bullet_count == MAX_LIVE_BULLETS) continue;
+        SimBullet& target = bullets[bullet_count++];
+        target.x = static_cast<int16_t>(bullet.getX());
+        target.y = static_cast<int16_t>(bullet.getY());
+        target.direction = static_cast<uint8_t>(bullet.getDirection());
+        target.owner_id = bullet.getOwnerId();
+    }
+}
+
+void SimState::copyFrom(const SimState& other) {
+    std::memcpy(this, &other, offsetof(SimState, bullets) + other.bullet_count * sizeof(SimBullet));
+}
+
+void SimState::moveTank(SimTank& tank, char tank_id, Move move) {
+    switch (move) {
+        case M_Forward:
+            tank.x += DX[tank.direction] * TANK_SPEED;
+            tank.y += DY[tank.direction] * TANK_SPEED;
+            break;
+        case M_Left:  tank.direction = turnLeft(tank.direction); break;
+        case M_Right: tank.direction = turnRight(tank.direction); break;
+    }
+
+    if (tank.shoot_counter > 0) tank.shoot_counter--;
+    if (tank.shoot_counter == 0 && bullet_count < MAX_LIVE_BULLETS) {
+        SimBullet& bullet = bullets[bullet_count++];
+        bullet.x = static_cast<int16_t>(tank.x + DX[tank.direction] * BULLET_SPAWN_DISTANCE);
+        bullet.y = static_cast<int16_t>(tank.y + DY[tank.direction] * BULLET_SPAWN_DISTANCE);
+        bullet.direction = static_cast<uint8_t>(tank.direction);
+        bullet.owner_id = tank_id;
+        tank.shoot_counter = SHOOT_INTERVAL - 1;
+    }
+}
+
+GameResult SimState::step(Move move_a, Move move_b) {
+    if (!turn_started) {
+        turn++;
+        map_turn_count++;
+        if (map_turn_count % MAP_SHRINK_INTERVAL == 0 && map_size > 2) map_size -= 2;
+    }
+    if (!a_moved) moveTank(tanks[0], 'A', move_a);
+    moveTank(tanks[1], 'B', move_b);
+    turn_started = false;
+    a_moved = false;
+
+    if (tanks[0].x == tanks[1].x && tanks[0].y == tanks[1].y) {
+        result = checkEnd();
+        return result;
+    }
+
+    // move, drop what left the area, and hit; tanks do not move meanwhile
+    const int boundary = BULLET_AREA + BULLET_OUT_OF_BOUNDS_OFFSET;
+    int kept = 0;
+    for (int i = 0; i < bullet_count; i++) {
+        SimBullet bullet = bullets[i];
+        bullet.x = static_cast<int16_t>(bullet.x + DX[bullet.direction] * BULLET_SPEED);
+        bullet.y = static_cast<int16_t>(bullet.y + DY[bullet.direction] * BULLET_SPEED);
+        if (bullet.x < -boundary || bullet.x >= boundary || bullet.y < -boundary || bullet.y >= boundary) continue;
+
+        bool hit = false;
+        for (int t = 0; t < 2 && !hit; t++) {
+            if (bullet.x == tanks[t].x && bullet.y == tanks[t].y && bullet.owner_id != 'A' + t) {
+                tanks[t].life_points -= BULLET_DAMAGE;
+                if (tanks[t].life_points < 0) tanks[t].life_points = 0;
+                hit = true;
+            }
+        }
+        if (!hit) bullets[kept++] = bullet;
+    }
+    bullet_count = kept;
+
+    for (SimTank& tank : tanks) {
+        if (!isInBounds(tank.x, tank.y)) {
+            tank.life_points -= OUT_OF_MAP_DAMAGE;
+            if (tank.life_points < 0) tank.life_points = 0;
+        }
+    }
+
+    result = checkEnd();
+    return result;
+}
+
+static inline uint64_t mixHash(uint64_t hash, uint64_t value) {
+    hash ^= value + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+uint64_t SimState::hash() const {
+    uint64_t hash = static_cast<uint64_t>(map_size) << 32 | static_cast<uint64_t>(turn_started) << 9 |
+                    static_cast<uint64_t>(a_moved) << 8 | static_cast<uint32_t>(map_turn_count % MAP_SHRINK_INTERVAL);
+    for (const SimTank& tank : tanks) {
+        hash = mixHash(hash, static_cast<uint64_t>(tank.x & 0xFF) | (tank.y & 0xFF) << 8 | tank.direction << 16 |
+                             static_cast<uint64_t>(tank.life_points & 0xFFFF) << 24 |
+                             static_cast<uint64_t>(tank.shoot_counter & 0xFF) << 40);
+    }
+    for (int i = 0; i < bullet_count; i++) {
+        const SimBullet& bullet = bullets[i];
+        hash = mixHash(hash, static_cast<uint64_t>(bullet.x & 0xFFFF) | static_cast<uint64_t>(bullet.y & 0xFFFF) << 16 |
+                             static_cast<uint64_t>(bullet.direction) << 32 | static_cast<uint64_t>(bullet.owner_id) << 40);
+    }
+    // the final mix spreads low-bit differences over the table index
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+GameResult SimState::checkEnd() const {
+    const SimTank& a = tanks[0];
+    const SimTank& b = tanks[1];
+    if (a.x == b.x && a.y == b.y) {
+        if (a.life_points > b.life_points) return TANK_A_WIN;
+        if (b.life_points > a.life_points) return TANK_B_WIN;
+        return DRAW;
+    }
+    bool a_alive = a.life_points > 0;
+    bool b_alive = b.life_points > 0;
+    if (!a_alive && !b_alive) return DRAW;
+    if (!a_alive) return TANK_B_WIN;
+    if (!b_alive) return TANK_A_WIN;
+    return GAME_CONTINUE;
+}
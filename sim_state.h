@@ -0,0 +1,61 @@
+// sim_state.h
+
+#ifndef SIM_STATE_H
+#define SIM_STATE_H
+
+#include <cstdint>
+#include "common.h"
+
+class GameCore;
+
+struct SimTank {
+    int x, y;
+    Direction direction;
+    int life_points;
+    int shoot_counter;
+};
+
+struct SimBullet {
+    int16_t x, y;
+    uint8_t direction;
+    char owner_id;
+};
+
+// A whole match in one flat, trivially copyable block for search: the same
+// rules as GameCore::applyMove/finishTurn, without objects, events or heap.
+// Bullets that hit or leave are dropped right away instead of a turn later,
+// which changes nothing a player can observe.
+struct SimState {
+    SimTank tanks[2]; // A, B
+    int turn;
+    int map_size;
+    int map_turn_count;
+    bool turn_started; // beginTurn already ran for the next step
+    bool a_moved;      // and tank A has made its move of it
+    GameResult result;
+    int bullet_count;
+    SimBullet bullets[MAX_LIVE_BULLETS];
+
+    // the board as the AI of deciding_id sees it: the turn has begun and, when
+    // B decides, A has moved already
+    void capture(const GameCore& core, char deciding_id);
+    // copies only the bullets in use
+    void copyFrom(const SimState& other);
+
+    // plays (the rest of) one turn, A moves then B; returns the result after it
+    GameResult step(Move move_a, Move move_b);
+    // of everything that decides the rest of the match, so not of the turn number
+    uint64_t hash() const;
+
+    int getMinBound() const { return INITIAL_MAP_SIZE / 2 - map_size / 2; }
+    int getMaxBound() const { return INITIAL_MAP_SIZE / 2 + map_size / 2 - 1; }
+    bool isInBounds(int x, int y) const {
+        return x >= getMinBound() && x <= getMaxBound() && y >= getMinBound() && y <= getMaxBound();
+    }
+
+private:
+    void moveTank(SimTank& tank, char tank_id, Move move);
+    GameResult checkEnd() const;
+};
+
+#endif // SIM_STATE_H
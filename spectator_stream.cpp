@@ -0,0 +1,301 @@
+// spectator_stream.cpp
+
+#include "spectator_stream.h"
+#include <cstdlib>
+#include <cctype>
+#include <algorithm>
+#include <fcntl.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <csignal>
+#else
+#include <io.h>
+#endif
+
+static const char* directionCode(Direction dir) {
+    switch (dir) {
+        case D_Left:  return "L";
+        case D_Up:    return "U";
+        case D_Right: return "R";
+        case D_Down:  return "D";
+        default:      return "?";
+    }
+}
+
+static bool isNumber(const std::string& text) {
+    if (text.empty()) return false;
+    for (char c : text) {
+        if (!std::isdigit(static_cast<unsigned char>(c))) return false;
+    }
+    return true;
+}
+
+SpectatorStream::SpectatorStream()
+    : fd(-1), owns_fd(false), spawned_from(0), next_bullet_id(0), has_previous(false) {
+    line.reserve(4096);
+}
+
+SpectatorStream::~SpectatorStream() {
+    close();
+}
+
+bool SpectatorStream::open(const std::string& target) {
+    close();
+
+    if (isNumber(target)) {
+        fd = std::atoi(target.c_str());
+        owns_fd = false;
+    } else {
+        fd = ::open(target.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        owns_fd = true;
+    }
+    if (fd < 0) return false;
+
+#ifndef _WIN32
+    // a dashboard going away must not kill the game
+    signal(SIGPIPE, SIG_IGN);
+#endif
+    has_previous = false;
+    next_bullet_id = 0;
+    writeHeader();
+    return isOpen();
+}
+
+void SpectatorStream::close() {
+    if (fd >= 0 && owns_fd) {
+        ::close(fd);
+    }
+    fd = -1;
+    owns_fd = false;
+}
+
+void SpectatorStream::writeHeader() {
+    line.clear();
+    line += "{\"t\":\"header\",\"format\":\"tankwar-spectate\",\"version\":";
+    appendInt(SPECTATE_FORMAT_VERSION);
+    line += ",\"keyframe_interval\":";
+    appendInt(SPECTATE_KEYFRAME_INTERVAL);
+    line += ",\"bullet_speed\":";
+    appendInt(BULLET_SPEED);
+    line += ",\"initial_map_size\":";
+    appendInt(INITIAL_MAP_SIZE);
+    line += ",\"doc\":\"snap: full state (turn, map{size,min,max}, tanks{A,B:{x,y,dir,life}},"
+            " bullets[{id,x,y,dir,owner}]). delta: changes since the previous line; tanks lists"
+            " only moved/turned tanks, life only changed values, spawn new bullets, remove ids"
+            " of bullets that hit or left this turn, map only on shrink. Bullets not mentioned"
+            " moved bullet_speed cells along dir. dir is L/U/R/D. end: final turn and result A/B/draw.\"}";
+    flushLine();
+}
+
+void SpectatorStream::writeTurn(const GameSnapshot& snapshot) {
+    if (!isOpen()) return;
+
+    current = snapshot;
+    // a bullet that hit or left this turn is only swept out next turn, but the
+    // client should see it gone now
+    current.bullets.erase(
+        std::remove_if(current.bullets.begin(), current.bullets.end(),
+            [](const BulletSnapshot& bullet) {
+                return !bullet.active;
+            }),
+        current.bullets.end()
+    );
+    assignBulletIds();
+
+    line.clear();
+    if (!has_previous || current.current_turn % SPECTATE_KEYFRAME_INTERVAL == 0) {
+        appendSnapshot();
+    } else {
+        appendDelta();
+    }
+    flushLine();
+
+    std::swap(previous, current);
+    std::swap(previous_ids, current_ids);
+    has_previous = true;
+}
+
+void SpectatorStream::writeEnd(int turn, GameResult result) {
+    if (!isOpen()) return;
+
+    line.clear();
+    line += "{\"t\":\"end\",\"turn\":";
+    appendInt(turn);
+    line += ",\"result\":\"";
+    switch (result) {
+        case TANK_A_WIN: line += "A"; break;
+        case TANK_B_WIN: line += "B"; break;
+        case DRAW:       line += "draw"; break;
+        default:         line += "none"; break;
+    }
+    line += "\"}";
+    flushLine();
+}
+
+// Surviving bullets keep their order in the engine and new ones are appended,
+// so walking both lists in step is enough to match them up.
+void SpectatorStream::assignBulletIds() {
+    current_ids.resize(current.bullets.size());
+    removed_ids.clear();
+
+    size_t next = 0;
+    if (has_previous) {
+        for (size_t i = 0; i < previous.bullets.size(); i++) {
+            const BulletSnapshot& old_bullet = previous.bullets[i];
+            int expected_x = old_bullet.x, expected_y = old_bullet.y;
+            switch (old_bullet.direction) {
+                case D_Left:  expected_x -= BULLET_SPEED; break;
+                case D_Up:    expected_y -= BULLET_SPEED; break;
+                case D_Right: expected_x += BULLET_SPEED; break;
+                case D_Down:  expected_y += BULLET_SPEED; break;
+            }
+
+            if (next < current.bullets.size()) {
+                const BulletSnapshot& candidate = current.bullets[next];
+                if (candidate.x == expected_x && candidate.y == expected_y &&
+                    candidate.direction == old_bullet.direction &&
+                    candidate.owner_id == old_bullet.owner_id) {
+                    current_ids[next++] = previous_ids[i];
+                    continue;
+                }
+            }
+            removed_ids.push_back(previous_ids[i]);
+        }
+    }
+
+    spawned_from = next;
+    for (; next < current.bullets.size(); next++) {
+        current_ids[next] = next_bullet_id++;
+    }
+}
+
+void SpectatorStream::appendSnapshot() {
+    line += "{\"t\":\"snap\",\"turn\":";
+    appendInt(current.current_turn);
+    line += ",";
+    appendMap(current.map_size);
+    line += ",\"tanks\":{\"A\":";
+    appendTank(current.tank_a, true);
+    line += ",\"B\":";
+    appendTank(current.tank_b, true);
+    line += "},\"bullets\":[";
+    for (size_t i = 0; i < current.bullets.size(); i++) {
+        if (i > 0) line += ",";
+        appendBullet(current.bullets[i], current_ids[i]);
+    }
+    line += "]}";
+}
+
+void SpectatorStream::appendDelta() {
+    line += "{\"t\":\"delta\",\"turn\":";
+    appendInt(current.current_turn);
+
+    const TankSnapshot* old_tanks[2] = {&previous.tank_a, &previous.tank_b};
+    const TankSnapshot* new_tanks[2] = {&current.tank_a, &current.tank_b};
+    const char* names[2] = {"A", "B"};
+
+    bool opened = false;
+    for (int i = 0; i < 2; i++) {
+        if (old_tanks[i]->x == new_tanks[i]->x && old_tanks[i]->y == new_tanks[i]->y &&
+            old_tanks[i]->direction == new_tanks[i]->direction) continue;
+        line += opened ? ",\"" : ",\"tanks\":{\"";
+        line += names[i];
+        line += "\":";
+        appendTank(*new_tanks[i], false);
+        opened = true;
+    }
+    if (opened) line += "}";
+
+    opened = false;
+    for (int i = 0; i < 2; i++) {
+        if (old_tanks[i]->life_points == new_tanks[i]->life_points) continue;
+        line += opened ? ",\"" : ",\"life\":{\"";
+        line += names[i];
+        line += "\":";
+        appendInt(new_tanks[i]->life_points);
+        opened = true;
+    }
+    if (opened) line += "}";
+
+    if (spawned_from < current.bullets.size()) {
+        line += ",\"spawn\":[";
+        for (size_t i = spawned_from; i < current.bullets.size(); i++) {
+            if (i > spawned_from) line += ",";
+            appendBullet(current.bullets[i], current_ids[i]);
+        }
+        line += "]";
+    }
+
+    if (!removed_ids.empty()) {
+        line += ",\"remove\":[";
+        for (size_t i = 0; i < removed_ids.size(); i++) {
+            if (i > 0) line += ",";
+            appendInt(removed_ids[i]);
+        }
+        line += "]";
+    }
+
+    if (current.map_size != previous.map_size) {
+        line += ",";
+        appendMap(current.map_size);
+    }
+    line += "}";
+}
+
+void SpectatorStream::appendTank(const TankSnapshot& tank, bool with_life) {
+    line += "{\"x\":";
+    appendInt(tank.x);
+    line += ",\"y\":";
+    appendInt(tank.y);
+    line += ",\"dir\":\"";
+    line += directionCode(tank.direction);
+    line += "\"";
+    if (with_life) {
+        line += ",\"life\":";
+        appendInt(tank.life_points);
+    }
+    line += "}";
+}
+
+void SpectatorStream::appendBullet(const BulletSnapshot& bullet, int id) {
+    line += "{\"id\":";
+    appendInt(id);
+    line += ",\"x\":";
+    appendInt(bullet.x);
+    line += ",\"y\":";
+    appendInt(bullet.y);
+    line += ",\"dir\":\"";
+    line += directionCode(bullet.direction);
+    line += "\",\"owner\":\"";
+    line += bullet.owner_id;
+    line += "\"}";
+}
+
+void SpectatorStream::appendMap(int size) {
+    int min = INITIAL_MAP_SIZE / 2 - size / 2;
+    line += "\"map\":{\"size\":";
+    appendInt(size);
+    line += ",\"min\":";
+    appendInt(min);
+    line += ",\"max\":";
+    appendInt(min + size - 1);
+    line += "}";
+}
+
+void SpectatorStream::appendInt(int value) {
+    ::appendInt(line, value);
+}
+
+void SpectatorStream::flushLine() {
+    line += '\n';
+    size_t written = 0;
+    while (written < line.size()) {
+        long n = ::write(fd, line.data() + written, static_cast<unsigned int>(line.size() - written));
+        if (n <= 0) {
+            close(); // reader went away; stop streaming but keep playing
+            return;
+        }
+        written += static_cast<size_t>(n);
+    }
+}
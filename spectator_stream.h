@@ -0,0 +1,66 @@
+// spectator_stream.h
+
+#ifndef SPECTATOR_STREAM_H
+#define SPECTATOR_STREAM_H
+
+#include <string>
+#include <vector>
+#include "common.h"
+#include "game_snapshot.h"
+
+// JSON-lines stream for external dashboards, one line per turn:
+//   {"t":"header",...}  format description, always the first line
+//   {"t":"snap",...}    full state at the start and every SPECTATE_KEYFRAME_INTERVAL turns
+//   {"t":"delta",...}   only what changed: moved tanks, life, spawned/removed bullets, map
+//   {"t":"end",...}     final result
+// Bullets are not repeated while they fly: a client advances every known bullet
+// by BULLET_SPEED cells along its direction each turn until it is removed, which
+// happens on the turn the bullet hits or leaves the board.
+
+const int SPECTATE_FORMAT_VERSION = 1;
+const int SPECTATE_KEYFRAME_INTERVAL = 32;
+
+class SpectatorStream {
+private:
+    int fd;
+    bool owns_fd;
+    std::string line; // reused for every line
+
+    GameSnapshot previous;
+    GameSnapshot current;
+    std::vector<int> previous_ids; // spectator-assigned bullet ids, parallel to bullets
+    std::vector<int> current_ids;
+    std::vector<int> removed_ids;
+    size_t spawned_from; // first index of bullets new this turn
+    int next_bullet_id;
+    bool has_previous;
+
+public:
+    SpectatorStream();
+    ~SpectatorStream();
+
+    SpectatorStream(const SpectatorStream&) = delete;
+    SpectatorStream& operator=(const SpectatorStream&) = delete;
+
+    // target is a file descriptor number or a file path
+    bool open(const std::string& target);
+    void close();
+    bool isOpen() const { return fd >= 0; }
+
+    // snapshot is the state at the end of a turn (or turn 0 before the first move)
+    void writeTurn(const GameSnapshot& snapshot);
+    void writeEnd(int turn, GameResult result);
+
+private:
+    void writeHeader();
+    void assignBulletIds();
+    void appendSnapshot();
+    void appendDelta();
+    void appendTank(const TankSnapshot& tank, bool with_life);
+    void appendBullet(const BulletSnapshot& bullet, int id);
+    void appendMap(int size);
+    void appendInt(int value);
+    void flushLine();
+};
+
+#endif // SPECTATOR_STREAM_H
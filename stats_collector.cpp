@@ -0,0 +1,50 @@
+// stats_collector.cpp
+
+#include "stats_collector.h"
+#include <sstream>
+
+StatsCollector::StatsCollector()
+    : turns(0), bullet_moves(0), map_shrinks(0), dropped_events(0) {
+}
+
+StatsCollector::~StatsCollector() {}
+
+void StatsCollector::handleEvent(const GameEvent& event) {
+    TankStats& tank = (event.tank_id == 'B') ? tank_b : tank_a;
+    switch (event.type) {
+        case EV_TANK_MOVE:  tank.moves++; break;
+        case EV_TANK_SHOOT: tank.shots++; break;
+        case EV_BULLET_MOVE: bullet_moves++; break;
+        case EV_BULLET_HIT: tank.hits_taken++; break;
+        case EV_TANK_DAMAGE:
+            if (event.detail == DAMAGE_OUT_OF_MAP) tank.map_damage_taken += OUT_OF_MAP_DAMAGE;
+            else tank.bullet_damage_taken += BULLET_DAMAGE;
+            break;
+        case EV_MAP_SHRINK: map_shrinks++; break;
+        case EV_TURN_END: turns = event.turn; break;
+        default: break;
+    }
+}
+
+void StatsCollector::handleOverrun(uint64_t dropped) {
+    dropped_events += dropped;
+}
+
+std::string StatsCollector::getSummary() const {
+    std::stringstream ss;
+    ss << "=== Match Statistics ===\n";
+    ss << "Turns: " << turns << ", map shrinks: " << map_shrinks
+       << ", bullet moves: " << bullet_moves << "\n";
+    const TankStats* stats[2] = {&tank_a, &tank_b};
+    for (int i = 0; i < 2; i++) {
+        ss << "Tank " << static_cast<char>('A' + i) << ": shots=" << stats[i]->shots
+           << ", hits taken=" << stats[i]->hits_taken
+           << ", bullet damage=" << stats[i]->bullet_damage_taken
+           << ", out-of-map damage=" << stats[i]->map_damage_taken << "\n";
+    }
+    if (dropped_events > 0) {
+        ss << "(incomplete: " << dropped_events << " events dropped)\n";
+    }
+    ss << "========================";
+    return ss.str();
+}
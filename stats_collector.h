@@ -0,0 +1,43 @@
+// stats_collector.h
+
+#ifndef STATS_COLLECTOR_H
+#define STATS_COLLECTOR_H
+
+#include <string>
+#include <cstdint>
+#include "game_event.h"
+
+struct TankStats {
+    int moves;
+    int shots;
+    int hits_taken;
+    int bullet_damage_taken;
+    int map_damage_taken;
+
+    TankStats() : moves(0), shots(0), hits_taken(0), bullet_damage_taken(0), map_damage_taken(0) {}
+};
+
+// per-match counters, fed from the event bus on its own thread
+class StatsCollector : public GameEventHandler {
+private:
+    TankStats tank_a;
+    TankStats tank_b;
+    int turns;
+    int64_t bullet_moves;
+    int map_shrinks;
+    uint64_t dropped_events;
+
+public:
+    StatsCollector();
+    ~StatsCollector();
+
+    void handleEvent(const GameEvent& event) override;
+    void handleOverrun(uint64_t dropped) override;
+
+    // only safe to call after the subscriber thread has been joined
+    const TankStats& getTankStats(char tank_id) const { return (tank_id == 'A') ? tank_a : tank_b; }
+    int getTurns() const { return turns; }
+    std::string getSummary() const;
+};
+
+#endif // STATS_COLLECTOR_H
@@ -0,0 +1,303 @@
+// tablebase.cpp
+// tankwar-tablebase: solves the endgame on 6x6 and smaller maps by retrograde
+// analysis and writes the table that --tablebase maps. Then it checks what it
+// wrote: the file reads back through mmap with a matching checksum, the rules
+// the table was solved with agree with GameCore turn by turn, and an AI playing
+// from the table never does worse than the table says against the level-2 AI.
+// Reports generation time, file size and probe latency.
+
+#include "endgame_table.h"
+#include "ai_player.h"
+#include "game_core.h"
+#include "game_snapshot.h"
+#include "worker_pool.h"
+#include "tank.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <random>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <getopt.h>
+
+struct TablebaseOptions {
+    int max_life;
+    int threads;
+    int rule_checks;   // random turns replayed on GameCore
+    int games;         // table AI against level 2
+    uint64_t seed;
+    std::string out_filename;
+
+    TablebaseOptions()
+        : max_life(DEFAULT_LIFE_POINTS), threads(static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))),
+          rule_checks(200000), games(2000), seed(1), out_filename("tankwar-endgame.tb") {}
+};
+
+typedef std::chrono::steady_clock Clock;
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// two tanks apart inside the square, lives up to max_life
+static void drawPosition(std::mt19937_64& rng, int max_life, EndgameTable::Tank& a, EndgameTable::Tank& b) {
+    EndgameTable::Tank* tanks[2] = {&a, &b};
+    do {
+        for (EndgameTable::Tank* tank : tanks) {
+            tank->x = EndgameTable::MIN + static_cast<int>(rng() % EndgameTable::SIZE);
+            tank->y = EndgameTable::MIN + static_cast<int>(rng() % EndgameTable::SIZE);
+            tank->direction = static_cast<Direction>(rng() % 4);
+            tank->life_points = 1 + static_cast<int>(rng() % max_life);
+        }
+    } while (a.x == b.x && a.y == b.y);
+}
+
+// the board one turn before A decides in layer, without bullets: beginTurn
+// then brings the map to the layer's size and phase
+static void restoreBefore(GameCore& core, int layer, const EndgameTable::Tank& a, const EndgameTable::Tank& b) {
+    GameSnapshot snapshot;
+    int map_turn_count = (INITIAL_MAP_SIZE - EndgameTable::SIZE) / 2 * MAP_SHRINK_INTERVAL + layer;
+    int map_size = EndgameTable::layerMapSize(layer);
+    snapshot.map_turn_count = map_turn_count - 1;
+    snapshot.map_size = (map_turn_count % MAP_SHRINK_INTERVAL == 0) ? map_size + 2 : map_size;
+    snapshot.current_turn = snapshot.map_turn_count;
+    TankSnapshot* targets[2] = {&snapshot.tank_a, &snapshot.tank_b};
+    const EndgameTable::Tank* sources[2] = {&a, &b};
+    for (int i = 0; i < 2; i++) {
+        targets[i]->x = sources[i]->x;
+        targets[i]->y = sources[i]->y;
+        targets[i]->direction = sources[i]->direction;
+        targets[i]->life_points = sources[i]->life_points;
+    }
+    core.restoreSnapshot(snapshot);
+}
+
+static bool inSquare(const Tank& tank) {
+    return tank.getX() >= EndgameTable::MIN && tank.getX() <= EndgameTable::MAX &&
+           tank.getY() >= EndgameTable::MIN && tank.getY() <= EndgameTable::MAX;
+}
+
+// EndgameTable's turn against GameCore's, from random positions and moves
+static int checkRules(const TablebaseOptions& options, std::mt19937_64& rng) {
+    GameCore core;
+    int mismatches = 0, checked = 0;
+    for (int i = 0; i < options.rule_checks; i++) {
+        int layer = static_cast<int>(rng() % EndgameTable::LAYERS);
+        EndgameTable::Tank a, b;
+        drawPosition(rng, options.max_life, a, b);
+        Move move_a = static_cast<Move>(rng() % 3), move_b = static_cast<Move>(rng() % 3);
+        EndgameTable::Tank next_a = a, next_b = b;
+        if (!EndgameTable::applyMove(next_a, move_a) || !EndgameTable::applyMove(next_b, move_b)) continue;
+        GameResult expected = EndgameTable::finishTurn(layer, next_a, next_b);
+
+        restoreBefore(core, layer, a, b);
+        core.beginTurn();
+        bool same = EndgameTable::layerOf(core.getGameMap().getCurrentSize(), core.getGameMap().getTurnCount()) == layer;
+        core.applyMove('A', move_a);
+        core.applyMove('B', move_b);
+        if (!core.checkTankCollision()) core.finishTurn();
+        checked++;
+
+        const Tank* tanks[2] = {&core.getTankA(), &core.getTankB()};
+        const EndgameTable::Tank* solved[2] = {&next_a, &next_b};
+        same = same && core.checkGameEnd() == expected;
+        for (int t = 0; t < 2; t++) {
+            same = same && tanks[t]->getX() == solved[t]->x && tanks[t]->getY() == solved[t]->y &&
+                   tanks[t]->getDirection() == solved[t]->direction && tanks[t]->getLifePoints() == solved[t]->life_points;
+        }
+        if (!same && mismatches++ < 5) {
+            std::cerr << "tablebase: rules differ in layer " << layer << " from A (" << a.x << "," << a.y << ") B ("
+                      << b.x << "," << b.y << "), moves " << move_a << " " << move_b << std::endl;
+        }
+    }
+    std::cerr << "tablebase: " << checked << " random turns replayed on GameCore, " << mismatches << " differ" << std::endl;
+    return mismatches;
+}
+
+// probes from where the AI decides, cores restored ahead of the timing
+static void timeProbes(const EndgameTable& table, std::mt19937_64& rng) {
+    const int POSITIONS = 4096, ROUNDS = 64;
+    std::vector<std::unique_ptr<GameCore>> cores;
+    for (int i = 0; i < POSITIONS; i++) {
+        EndgameTable::Tank a, b;
+        drawPosition(rng, table.getMaxLife(), a, b);
+        cores.push_back(std::make_unique<GameCore>());
+        restoreBefore(*cores.back(), static_cast<int>(rng() % EndgameTable::LAYERS), a, b);
+        cores.back()->beginTurn();
+    }
+
+    int8_t values[3];
+    int covered = 0;
+    long long sum = 0;
+    Clock::time_point start = Clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (const std::unique_ptr<GameCore>& core : cores) {
+            if (!table.probe(*core, 'A', values)) continue;
+            covered++;
+            sum += values[0] + values[1] + values[2];
+        }
+    }
+    double seconds = secondsSince(start);
+    std::cerr << std::fixed << std::setprecision(1) << "tablebase: probe " << seconds * 1e9 / (POSITIONS * ROUNDS)
+              << " ns over " << POSITIONS << " random positions (" << covered / ROUNDS << " covered, sum " << sum
+              << ")" << std::endl;
+
+    AIPlayer ai('A', 2);
+    std::shared_ptr<const EndgameTable> shared(&table, [](const EndgameTable*) {});
+    ai.setEndgameTable(shared);
+    start = Clock::now();
+    for (const std::unique_ptr<GameCore>& core : cores) ai.makeDecision(*core);
+    seconds = secondsSince(start);
+    std::cerr << std::fixed << std::setprecision(1) << "tablebase: AI decision from the table "
+              << seconds * 1e9 / POSITIONS << " ns" << std::endl;
+}
+
+// the table's side must do at least as well as the table says, while both
+// tanks stay in the square; games the other side takes out of it do not count
+static int checkPlay(const TablebaseOptions& options, const std::shared_ptr<const EndgameTable>& table, std::mt19937_64& rng) {
+    GameCore core;
+    int score[3] = {0, 0, 0}, left = 0, violations = 0, misses = 0;
+    for (int game = 0; game < options.games; game++) {
+        int layer = static_cast<int>(rng() % EndgameTable::LAYERS);
+        EndgameTable::Tank a, b;
+        drawPosition(rng, options.max_life, a, b);
+        char table_id = (game % 2) ? 'B' : 'A';
+        int8_t value = table->lookup(layer, a, b);
+        if (table_id == 'B') value = static_cast<int8_t>(-value);
+
+        AIPlayer ai_a('A', 2, options.seed + game), ai_b('B', 2, options.seed + game);
+        AIPlayer& table_ai = (table_id == 'A') ? ai_a : ai_b;
+        table_ai.setEndgameTable(table);
+        restoreBefore(core, layer, a, b);
+
+        GameResult result = DRAW;
+        bool stayed = true;
+        int decisions = 0;
+        while (core.getCurrentTurn() < MAX_AI_MATCH_TURNS) {
+            core.beginTurn();
+            core.applyMove('A', ai_a.makeDecision(core));
+            if (table_id == 'A') decisions++;
+            core.applyMove('B', ai_b.makeDecision(core));
+            if (table_id == 'B') decisions++;
+            stayed = stayed && inSquare(core.getTankA()) && inSquare(core.getTankB());
+            if (core.checkTankCollision()) {
+                result = core.checkGameEnd();
+                break;
+            }
+            core.finishTurn();
+            result = core.checkGameEnd();
+            if (result != GAME_CONTINUE) break;
+            if (!stayed) break;
+        }
+        if (result == GAME_CONTINUE) result = DRAW;
+        if (!stayed) {
+            left++;
+            continue;
+        }
+        if (table_ai.getEndgameMoves() != static_cast<uint64_t>(decisions)) misses++;
+
+        bool won = (result == TANK_A_WIN) == (table_id == 'A') && result != DRAW;
+        bool lost = result != DRAW && !won;
+        score[won ? 0 : lost ? 2 : 1]++;
+        if ((value > 0 && !won) || (value == 0 && lost)) violations++;
+    }
+    std::cerr << "tablebase: table AI vs level 2 from " << options.games << " random endgames: +" << score[0] << " ="
+              << score[1] << " -" << score[2] << ", " << left << " taken out of the square, " << violations
+              << " below the table's value, " << misses << " with decisions off the table" << std::endl;
+    return violations + misses;
+}
+
+static void printUsage(const char* program) {
+    TablebaseOptions defaults;
+    std::cout << "Usage: " << program << " [options]\n";
+    std::cout << "Options:\n";
+    std::cout << "  -h | --help            Print this help message and exit.\n";
+    std::cout << "  --max-life=<n>         Highest life points the table covers, 1-" << EndgameTable::MAX_LIFE
+              << ". (Default: " << defaults.max_life << ")\n";
+    std::cout << "  --threads=<n>          Threads of the retrograde passes. (Default: cores, " << defaults.threads << ")\n";
+    std::cout << "  --rule-checks=<n>      Random turns replayed on GameCore, 0 to skip. (Default: " << defaults.rule_checks << ")\n";
+    std::cout << "  --games=<n>            Endgames played from the table against level 2, 0 to skip. (Default: " << defaults.games << ")\n";
+    std::cout << "  --seed=<n>             Seed of those checks. (Default: " << defaults.seed << ")\n";
+    std::cout << "  --out=<file>           Where the table goes. (Default: " << defaults.out_filename << ")\n";
+}
+
+static bool parseInt(const char* text, const char* what, int min_value, int max_value, int& value) {
+    value = std::atoi(text);
+    if (value < min_value || value > max_value) {
+        std::cerr << "Error: Invalid " << what << ": " << text << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    TablebaseOptions options;
+
+    static struct option long_options[] = {
+        {"help", no_argument, 0, 'h'},
+        {"max-life", required_argument, 0, 'l'},
+        {"threads", required_argument, 0, 't'},
+        {"rule-checks", required_argument, 0, 'r'},
+        {"games", required_argument, 0, 'g'},
+        {"seed", required_argument, 0, 'S'},
+        {"out", required_argument, 0, 'o'},
+        {0, 0, 0, 0}
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "h", long_options, nullptr)) != -1) {
+        bool ok = true;
+        switch (opt) {
+            case 'h': printUsage(argv[0]); return 0;
+            case 'l': ok = parseInt(optarg, "max life", 1, EndgameTable::MAX_LIFE, options.max_life); break;
+            case 't': ok = parseInt(optarg, "threads", 1, MAX_SEARCH_THREADS, options.threads); break;
+            case 'r': ok = parseInt(optarg, "rule checks", 0, 100000000, options.rule_checks); break;
+            case 'g': ok = parseInt(optarg, "games", 0, 10000000, options.games); break;
+            case 'S': options.seed = std::strtoull(optarg, nullptr, 10); break;
+            case 'o': options.out_filename = optarg; break;
+            default: printUsage(argv[0]); return 1;
+        }
+        if (!ok) return 1;
+    }
+
+    EndgameTable::Stats stats;
+    {
+        EndgameTable generated;
+        WorkerPool pool(options.threads);
+        std::cerr << "tablebase: lives up to " << options.max_life << ", " << EndgameTable::LAYERS << " layers on "
+                  << options.threads << " threads" << std::endl;
+        generated.generate(options.max_life, &pool, stats);
+        std::cerr << std::fixed << std::setprecision(2) << "tablebase: generated in " << stats.seconds << " s, "
+                  << stats.passes << " passes, longest forced result " << stats.longest << " turns; for A +"
+                  << stats.wins << " =" << stats.draws << " -" << stats.losses << std::endl;
+        if (!generated.save(options.out_filename)) {
+            std::cerr << "Error: Cannot write " << options.out_filename << std::endl;
+            return 1;
+        }
+    }
+
+    auto table = std::make_shared<EndgameTable>();
+    std::string error;
+    Clock::time_point start = Clock::now();
+    if (!table->open(options.out_filename, error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+    double open_seconds = secondsSince(start);
+    if (!table->verifyChecksum()) {
+        std::cerr << "Error: " << options.out_filename << ": checksum does not match" << std::endl;
+        return 1;
+    }
+    std::cerr << std::fixed << std::setprecision(1) << "tablebase: " << options.out_filename << ", "
+              << table->getFileSize() << " bytes (" << table->getFileSize() / 1048576.0 << " MiB), mapped in "
+              << open_seconds * 1e6 << " us, checksum ok" << std::endl;
+
+    std::mt19937_64 rng(options.seed);
+    int failures = checkRules(options, rng);
+    timeProbes(*table, rng);
+    failures += checkPlay(options, table, rng);
+    return failures ? 1 : 0;
+}
@@ -1,7 +1,6 @@
 // tank.cpp
 
 #include "tank.h"
-#include <iostream>
 
 Tank::Tank(int init_x, int init_y, Direction init_dir, int init_life, char id)
     : x(init_x), y(init_y), direction(init_dir), life_points(init_life), 
@@ -76,6 +75,10 @@ void Tank::setLifePoints(int new_life) {
     }
 }
 
+void Tank::setShootCounter(int counter) {
+    shoot_counter = (counter < 0) ? 0 : counter;
+}
+
 bool Tank::isAtPosition(int check_x, int check_y) const {
     return x == check_x && y == check_y;
 }
@@ -39,6 +39,7 @@ public:
     void setPosition(int new_x, int new_y);
     void setDirection(Direction new_dir);
     void setLifePoints(int new_life);
+    void setShootCounter(int counter);
     
     bool isAtPosition(int check_x, int check_y) const;
     void getNextPosition(int& next_x, int& next_y) const;
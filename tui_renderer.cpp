@@ -0,0 +1,120 @@
+// tui_renderer.cpp
+
+#include "tui_renderer.h"
+#include "ui_manager.h"
+#include <iostream>
+#include <algorithm>
+
+TuiRenderer::TuiRenderer(const UIManager& ui)
+    : ui_manager(ui), has_previous(false), bytes_written(0), frames(0) {
+    screen.assign(TUI_SCREEN_WIDTH * TUI_SCREEN_HEIGHT, ' ');
+    previous.assign(TUI_SCREEN_WIDTH * TUI_SCREEN_HEIGHT, ' ');
+    output.reserve(TUI_SCREEN_WIDTH * TUI_SCREEN_HEIGHT * 2);
+}
+
+TuiRenderer::~TuiRenderer() {
+    finish();
+}
+
+void TuiRenderer::render(const GameSnapshot& snapshot) {
+    composeScreen(snapshot);
+
+    output.clear();
+    if (!has_previous) {
+        // start from a blank screen, which is what previous holds
+        output += "\033[2J\033[?25l";
+        std::fill(previous.begin(), previous.end(), ' ');
+    }
+    appendChanges();
+
+    // park the cursor under the board so prompts and messages land there
+    appendCursor(TUI_SCREEN_HEIGHT, 0);
+    output += "\033[J";
+    flushOutput();
+
+    previous.swap(screen);
+    has_previous = true;
+    frames++;
+}
+
+void TuiRenderer::finish() {
+    if (!has_previous) return;
+    output.clear();
+    appendCursor(TUI_SCREEN_HEIGHT, 0);
+    output += "\033[?25h";
+    flushOutput();
+    has_previous = false;
+}
+
+// same text as printGameMap followed by the status block, laid out on a cell grid
+void TuiRenderer::composeScreen(const GameSnapshot& snapshot) {
+    ui_manager.composeMapFrame(snapshot, frame_text, true);
+
+    const TankSnapshot* tanks[2] = {&snapshot.tank_a, &snapshot.tank_b};
+    for (int i = 0; i < 2; i++) {
+        frame_text += "Tank ";
+        frame_text += static_cast<char>('A' + i);
+        frame_text += ": Life=";
+        appendInt(frame_text, tanks[i]->life_points);
+        frame_text += ", Position=(";
+        appendInt(frame_text, tanks[i]->x);
+        frame_text += ",";
+        appendInt(frame_text, tanks[i]->y);
+        frame_text += "), Direction=";
+        frame_text += directionName(tanks[i]->direction);
+        frame_text += '\n';
+    }
+    frame_text += "Map Size: ";
+    appendInt(frame_text, snapshot.map_size);
+    frame_text += "x";
+    appendInt(frame_text, snapshot.map_size);
+    frame_text += '\n';
+
+    std::fill(screen.begin(), screen.end(), ' ');
+    int row = 0, col = 0;
+    for (char c : frame_text) {
+        if (c == '\n') {
+            if (++row >= TUI_SCREEN_HEIGHT) break;
+            col = 0;
+        } else if (col < TUI_SCREEN_WIDTH) {
+            screen[row * TUI_SCREEN_WIDTH + col++] = c;
+        }
+    }
+}
+
+void TuiRenderer::appendChanges() {
+    for (int row = 0; row < TUI_SCREEN_HEIGHT; row++) {
+        const char* now = &screen[row * TUI_SCREEN_WIDTH];
+        const char* before = &previous[row * TUI_SCREEN_WIDTH];
+
+        int col = 0;
+        while (col < TUI_SCREEN_WIDTH) {
+            if (now[col] == before[col]) {
+                col++;
+                continue;
+            }
+            // grow the run over short stretches of unchanged cells
+            int last_changed = col;
+            for (int next = col + 1; next < TUI_SCREEN_WIDTH && next - last_changed <= TUI_MAX_GAP; next++) {
+                if (now[next] != before[next]) last_changed = next;
+            }
+            appendCursor(row, col);
+            output.append(now + col, last_changed - col + 1);
+            col = last_changed + 1;
+        }
+    }
+}
+
+void TuiRenderer::appendCursor(int row, int col) {
+    output += "\033[";
+    appendInt(output, row + 1);
+    output += ';';
+    appendInt(output, col + 1);
+    output += 'H';
+}
+
+void TuiRenderer::flushOutput() {
+    std::cout.write(output.data(), static_cast<std::streamsize>(output.size()));
+    std::cout.flush();
+    bytes_written += output.size();
+}
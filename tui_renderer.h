@@ -0,0 +1,55 @@
+// tui_renderer.h
+
+#ifndef TUI_RENDERER_H
+#define TUI_RENDERER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "common.h"
+#include "game_snapshot.h"
+
+class UIManager;
+
+// screen area owned by the renderer; enough for the full-size map and the status block
+const int TUI_SCREEN_WIDTH = 80;
+const int TUI_SCREEN_HEIGHT = INITIAL_MAP_SIZE + 6 + 3 + 3;
+// unchanged cells between two changes that are cheaper to resend than to jump over
+const int TUI_MAX_GAP = 6;
+
+// In-place terminal display for --tui. Keeps the screen it drew last and
+// sends only the cells that changed since, each run behind an ANSI cursor
+// move, as one write per turn. Scrollback no longer grows with every turn.
+class TuiRenderer {
+private:
+    const UIManager& ui_manager;
+    std::string frame_text;
+    std::vector<char> screen;
+    std::vector<char> previous;
+    std::string output;
+    bool has_previous;
+    uint64_t bytes_written;
+    int frames;
+
+public:
+    explicit TuiRenderer(const UIManager& ui);
+    ~TuiRenderer();
+
+    TuiRenderer(const TuiRenderer&) = delete;
+    TuiRenderer& operator=(const TuiRenderer&) = delete;
+
+    void render(const GameSnapshot& snapshot);
+    // leaves the cursor below the board and visible again
+    void finish();
+
+    uint64_t getBytesWritten() const { return bytes_written; }
+    int getFrames() const { return frames; }
+
+private:
+    void composeScreen(const GameSnapshot& snapshot);
+    void appendChanges();
+    void appendCursor(int row, int col);
+    void flushOutput();
+};
+
+#endif // TUI_RENDERER_H
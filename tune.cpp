@@ -0,0 +1,328 @@
+// tune.cpp
+// tankwar-tune: searches for better weights of the rule-based AI by self-play,
+// with SPSA (simultaneous perturbation stochastic approximation). Every
+// iteration nudges all weights at once, each up or down at random, plays that
+// variant against the opposite one from fresh random starts, and moves every
+// weight towards whichever side won, in proportion to the margin. Every few
+// iterations the current weights play the defaults on a fixed set of starts,
+// and the best seen so far is written out for --ai-weights.
+//
+// The matches of a batch run on a WorkerPool. Each one has a slot of its own,
+// board and both AIs, set up again for every batch, so the results do not
+// depend on the thread count and nothing is allocated per match but the tanks.
+
+#include "ai_player.h"
+#include "ai_weights.h"
+#include "game_core.h"
+#include "worker_pool.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <random>
+#include <cmath>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <getopt.h>
+
+struct TuneOptions {
+    int iterations;
+    int starts;        // per iteration, each played from both sides
+    int check_every;
+    int check_starts;
+    int level;
+    int life_points;
+    int threads;
+    double rate;       // SPSA a: how far a won iteration moves the weights
+    double spread;     // SPSA c: perturbation, in steps of each weight
+    uint64_t seed;
+    std::string from_filename;
+    std::string out_filename;
+
+    TuneOptions()
+        : iterations(300), starts(128), check_every(25), check_starts(512), level(2),
+          life_points(DEFAULT_LIFE_POINTS), threads(static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))),
+          rate(16.0), spread(1.0), seed(1), out_filename("tankwar-weights.txt") {}
+};
+
+struct Start {
+    int x_a, y_a, x_b, y_b;
+    Direction dir_a, dir_b;
+};
+
+// one match of a batch: weights[0] plays A or B as the side says
+struct MatchSlot {
+    GameCore core;
+    AIPlayer ai_a;
+    AIPlayer ai_b;
+    Start start;
+    int side;          // 0: weights[0] is A
+    double margin;     // for weights[0]: 1 won, -1 lost, a draw by the life left
+
+    explicit MatchSlot(int level) : ai_a('A', level), ai_b('B', level), start(), side(0), margin(0) {}
+};
+
+class MatchBatch : public WorkerPool::Job {
+private:
+    std::vector<std::unique_ptr<MatchSlot>> slots;
+    AIWeights weights[2];
+    int life_points;
+
+public:
+    MatchBatch(int level, int life_points, int max_matches) : life_points(life_points) {
+        for (int i = 0; i < max_matches; i++) slots.push_back(std::make_unique<MatchSlot>(level));
+    }
+
+    // both weights from every start and side; the mean margin of the first
+    double play(WorkerPool& pool, const AIWeights& first, const AIWeights& second,
+                const std::vector<Start>& starts, int score[3]) {
+        weights[0] = first;
+        weights[1] = second;
+        int matches = static_cast<int>(starts.size()) * 2;
+        for (int i = 0; i < matches; i++) {
+            slots[i]->start = starts[i / 2];
+            slots[i]->side = i % 2;
+        }
+        pool.run(*this, matches);
+
+        double total = 0;
+        score[0] = score[1] = score[2] = 0;
+        for (int i = 0; i < matches; i++) {
+            double margin = slots[i]->margin;
+            total += margin;
+            score[(margin == 1) ? 0 : (margin == -1) ? 2 : 1]++;
+        }
+        return total / matches;
+    }
+
+    void runTask(int task) override {
+        MatchSlot& slot = *slots[task];
+        AIPlayer* players[2] = {&slot.ai_a, &slot.ai_b};
+        for (int i = 0; i < 2; i++) {
+            players[i]->setWeights(weights[i ^ slot.side]);
+            players[i]->clearHistory();
+            players[i]->setEdgeLingerTurns(0);
+            players[i]->restoreRandomState(0);
+        }
+
+        const Start& start = slot.start;
+        slot.core.reset();
+        slot.core.placeTanks(start.x_a, start.y_a, start.dir_a, start.x_b, start.y_b, start.dir_b, life_points);
+        GameResult result = playAIMatch(slot.core, slot.ai_a, slot.ai_b);
+
+        char first_id = slot.side ? 'B' : 'A';
+        if (result == TANK_A_WIN || result == TANK_B_WIN) {
+            slot.margin = ((result == TANK_A_WIN) == (first_id == 'A')) ? 1 : -1;
+        } else {
+            // mostly out of turns with both tanks up; who kept more life still says something
+            int life_left = slot.core.getTankById(first_id).getLifePoints() - slot.core.getOtherTank(first_id).getLifePoints();
+            slot.margin = 0.5 * life_left / life_points;
+        }
+    }
+};
+
+static void drawStarts(std::mt19937_64& rng, int count, std::vector<Start>& starts) {
+    starts.resize(count);
+    for (Start& start : starts) {
+        do {
+            start.x_a = rng() % INITIAL_MAP_SIZE; start.y_a = rng() % INITIAL_MAP_SIZE;
+            start.x_b = rng() % INITIAL_MAP_SIZE; start.y_b = rng() % INITIAL_MAP_SIZE;
+        } while (start.x_a == start.x_b && start.y_a == start.y_b);
+        start.dir_a = static_cast<Direction>(rng() % 4);
+        start.dir_b = static_cast<Direction>(rng() % 4);
+    }
+}
+
+// a twentieth of the range, so that every weight takes about as many steps
+// to cross it; never below one
+static double stepOf(const AIWeightInfo& info) {
+    return std::max(1.0, (info.max_value - info.min_value) / 20.0);
+}
+
+static AIWeights roundWeights(const std::vector<double>& values) {
+    AIWeights weights;
+    for (int i = 0; i < AI_WEIGHT_COUNT; i++) {
+        const AIWeightInfo& info = AI_WEIGHT_INFO[i];
+        int value = static_cast<int>(std::lround(values[i]));
+        weights.*info.field = std::min(std::max(value, info.min_value), info.max_value);
+    }
+    return weights;
+}
+
+static void printWeights(const AIWeights& weights) {
+    for (const AIWeightInfo& info : AI_WEIGHT_INFO) {
+        std::cerr << " " << info.name << "=" << weights.*info.field;
+    }
+    std::cerr << std::endl;
+}
+
+static void printUsage(const char* program) {
+    TuneOptions defaults;
+    std::cout << "Usage: " << program << " [options]\n";
+    std::cout << "Options:\n";
+    std::cout << "  -h | --help            Print this help message and exit.\n";
+    std::cout << "  --iterations=<n>       SPSA iterations. (Default: " << defaults.iterations << ")\n";
+    std::cout << "  --starts=<n>           Random starts per iteration, each played from both sides. (Default: " << defaults.starts << ")\n";
+    std::cout << "  --check-every=<n>      Play the defaults every n iterations and keep the best. (Default: " << defaults.check_every << ")\n";
+    std::cout << "  --check-starts=<n>     Fixed starts of that check. (Default: " << defaults.check_starts << ")\n";
+    std::cout << "  --ai-level=<2|3>       Level whose weights are tuned. (Default: " << defaults.level << ")\n";
+    std::cout << "  --initial-life=<n>     Life points of both tanks. (Default: " << defaults.life_points << ")\n";
+    std::cout << "  --threads=<n>          Matches played at once. (Default: cores, " << defaults.threads << ")\n";
+    std::cout << "  --rate=<a>             How far a won iteration moves the weights, in steps. (Default: " << defaults.rate << ")\n";
+    std::cout << "  --spread=<c>           How far the two variants differ, in steps. (Default: " << defaults.spread << ")\n";
+    std::cout << "  --seed=<n>             Seed of the starts and perturbations. (Default: " << defaults.seed << ")\n";
+    std::cout << "  --from=<file>          Start from these weights instead of the defaults.\n";
+    std::cout << "  --out=<file>           Where the best weights go. (Default: " << defaults.out_filename << ")\n";
+}
+
+static bool parseInt(const char* text, const char* what, int min_value, int max_value, int& value) {
+    value = std::atoi(text);
+    if (value < min_value || value > max_value) {
+        std::cerr << "Error: Invalid " << what << ": " << text << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool parseReal(const char* text, const char* what, double& value) {
+    value = std::atof(text);
+    if (!(value > 0)) {
+        std::cerr << "Error: Invalid " << what << ": " << text << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    TuneOptions options;
+
+    static struct option long_options[] = {
+        {"help", no_argument, 0, 'h'},
+        {"iterations", required_argument, 0, 'i'},
+        {"starts", required_argument, 0, 's'},
+        {"check-every", required_argument, 0, 'k'},
+        {"check-starts", required_argument, 0, 'K'},
+        {"ai-level", required_argument, 0, 'l'},
+        {"initial-life", required_argument, 0, 'p'},
+        {"threads", required_argument, 0, 't'},
+        {"rate", required_argument, 0, 'a'},
+        {"spread", required_argument, 0, 'c'},
+        {"seed", required_argument, 0, 'S'},
+        {"from", required_argument, 0, 'f'},
+        {"out", required_argument, 0, 'o'},
+        {0, 0, 0, 0}
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "h", long_options, nullptr)) != -1) {
+        bool ok = true;
+        switch (opt) {
+            case 'h': printUsage(argv[0]); return 0;
+            case 'i': ok = parseInt(optarg, "iterations", 1, 1000000, options.iterations); break;
+            case 's': ok = parseInt(optarg, "starts", 1, 100000, options.starts); break;
+            case 'k': ok = parseInt(optarg, "check interval", 1, 1000000, options.check_every); break;
+            case 'K': ok = parseInt(optarg, "check starts", 1, 100000, options.check_starts); break;
+            case 'l': ok = parseInt(optarg, "AI level", 2, 3, options.level); break;
+            case 'p': ok = parseInt(optarg, "life points", 1, 100, options.life_points); break;
+            case 't': ok = parseInt(optarg, "threads", 1, MAX_SEARCH_THREADS, options.threads); break;
+            case 'a': ok = parseReal(optarg, "rate", options.rate); break;
+            case 'c': ok = parseReal(optarg, "spread", options.spread); break;
+            case 'S': options.seed = std::strtoull(optarg, nullptr, 10); break;
+            case 'f': options.from_filename = optarg; break;
+            case 'o': options.out_filename = optarg; break;
+            default: printUsage(argv[0]); return 1;
+        }
+        if (!ok) return 1;
+    }
+
+    AIWeights defaults;
+    AIWeights current;
+    if (!options.from_filename.empty()) {
+        std::string error;
+        if (!loadAIWeights(options.from_filename, current, error)) {
+            std::cerr << "Error: " << error << std::endl;
+            return 1;
+        }
+    }
+    std::vector<double> values(AI_WEIGHT_COUNT);
+    for (int i = 0; i < AI_WEIGHT_COUNT; i++) values[i] = current.*AI_WEIGHT_INFO[i].field;
+
+    WorkerPool pool(options.threads);
+    MatchBatch batch(options.level, options.life_points, 2 * std::max(options.starts, options.check_starts));
+    std::mt19937_64 rng(options.seed);
+    std::vector<Start> check_starts, starts;
+    drawStarts(rng, options.check_starts, check_starts);
+
+    // the usual SPSA schedules, with the stability constant at a tenth of the run
+    const double stability = options.iterations / 10.0;
+    AIWeights best = current;
+    double best_margin = -2;
+    int score[3];
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start_time = Clock::now();
+    uint64_t matches = 0;
+
+    std::cerr << "tune: level " << options.level << ", " << options.iterations << " iterations of "
+              << 2 * options.starts << " matches on " << options.threads << " threads" << std::endl;
+    for (int k = 0; k <= options.iterations; k++) {
+        if (k % options.check_every == 0 || k == options.iterations) {
+            AIWeights played = roundWeights(values);
+            double margin = batch.play(pool, played, defaults, check_starts, score);
+            matches += 2 * check_starts.size();
+            bool improved = margin > best_margin;
+            if (improved) {
+                best = played;
+                best_margin = margin;
+                std::string header = "tankwar-tune, level " + std::to_string(options.level) + ", iteration " +
+                                     std::to_string(k) + "\nagainst the defaults: +" + std::to_string(score[0]) +
+                                     " =" + std::to_string(score[1]) + " -" + std::to_string(score[2]);
+                if (!saveAIWeights(options.out_filename, best, header)) {
+                    std::cerr << "Error: Cannot write " << options.out_filename << std::endl;
+                    return 1;
+                }
+            }
+            std::cerr << std::fixed << std::setprecision(3) << "tune: iteration " << k << ": vs defaults +" << score[0]
+                      << " =" << score[1] << " -" << score[2] << ", margin " << margin << (improved ? ", saved" : "")
+                      << std::endl;
+        }
+        if (k == options.iterations) break;
+
+        double gain = options.rate / std::pow(k + 1 + stability, 0.602);
+        double spread = options.spread / std::pow(k + 1, 0.101);
+        std::vector<double> plus(values), minus(values), offsets(AI_WEIGHT_COUNT);
+        for (int i = 0; i < AI_WEIGHT_COUNT; i++) {
+            double step = stepOf(AI_WEIGHT_INFO[i]);
+            // rounded to whole numbers the two sides must still differ
+            offsets[i] = std::max(1.0, std::round(spread * step)) * ((rng() & 1) ? 1 : -1);
+            plus[i] += offsets[i];
+            minus[i] -= offsets[i];
+        }
+
+        drawStarts(rng, options.starts, starts);
+        double margin = batch.play(pool, roundWeights(plus), roundWeights(minus), starts, score);
+        matches += 2 * starts.size();
+        for (int i = 0; i < AI_WEIGHT_COUNT; i++) {
+            const AIWeightInfo& info = AI_WEIGHT_INFO[i];
+            double step = stepOf(info);
+            // the margin over twice the offset, in steps: a gradient in those units
+            values[i] += gain * step * margin * step / (2 * offsets[i]);
+            values[i] = std::min(std::max(values[i], static_cast<double>(info.min_value)), static_cast<double>(info.max_value));
+        }
+    }
+
+    // the checks picked the best, so they flatter it; fresh starts do not
+    drawStarts(rng, options.check_starts, check_starts);
+    double held_out = batch.play(pool, best, defaults, check_starts, score);
+    matches += 2 * check_starts.size();
+    std::cerr << std::fixed << std::setprecision(3) << "tune: best vs defaults on new starts +" << score[0] << " ="
+              << score[1] << " -" << score[2] << ", margin " << held_out << std::endl;
+
+    double seconds = std::chrono::duration<double>(Clock::now() - start_time).count();
+    std::cerr << std::fixed << std::setprecision(3) << "tune: " << matches << " matches in " << std::setprecision(1)
+              << seconds << " s, best margin " << std::setprecision(3) << best_margin << " against the defaults, in "
+              << options.out_filename << ":";
+    printWeights(best);
+    return 0;
+}
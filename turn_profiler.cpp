@@ -0,0 +1,121 @@
+// turn_profiler.cpp
+
+#include "turn_profiler.h"
+#include <sstream>
+#include <iomanip>
+
+static const char* phaseName(int phase) {
+    switch (phase) {
+        case PHASE_DECIDE:     return "decide";
+        case PHASE_MOVE:       return "tank move";
+        case PHASE_BULLETS:    return "bullets";
+        case PHASE_COLLISIONS: return "collisions";
+        case PHASE_MAP_DAMAGE: return "map damage";
+        case PHASE_LOGGING:    return "logging";
+        case PHASE_RENDER:     return "render";
+        default:               return "?";
+    }
+}
+
+LatencyHistogram::LatencyHistogram() : count(0), max_value(0) {
+    for (uint64_t& bucket : buckets) bucket = 0;
+}
+
+int LatencyHistogram::bucketOf(uint64_t value) {
+    if (value < 16) return static_cast<int>(value);
+    int exponent = 63 - __builtin_clzll(value); // >= 4
+    int sub = static_cast<int>(value >> (exponent - 3)) & (SUB_BUCKETS - 1);
+    return 16 + (exponent - 4) * SUB_BUCKETS + sub;
+}
+
+uint64_t LatencyHistogram::bucketLimit(int bucket) {
+    if (bucket < 16) return static_cast<uint64_t>(bucket);
+    int exponent = (bucket - 16) / SUB_BUCKETS + 4;
+    uint64_t sub = static_cast<uint64_t>((bucket - 16) % SUB_BUCKETS);
+    uint64_t step = 1ULL << (exponent - 3);
+    return (1ULL << exponent) + (sub + 1) * step - 1;
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds) {
+    buckets[bucketOf(nanoseconds)]++;
+    count++;
+    if (nanoseconds > max_value) max_value = nanoseconds;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (int i = 0; i < BUCKET_COUNT; i++) buckets[i] += other.buckets[i];
+    count += other.count;
+    if (other.max_value > max_value) max_value = other.max_value;
+}
+
+uint64_t LatencyHistogram::getPercentile(double fraction) const {
+    if (count == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(fraction * count + 0.5);
+    if (rank < 1) rank = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        seen += buckets[i];
+        if (seen >= rank) return bucketLimit(i) < max_value ? bucketLimit(i) : max_value;
+    }
+    return max_value;
+}
+
+TurnProfiler::TurnProfiler() : touched(0) {
+    for (uint64_t& total : turn_totals) total = 0;
+}
+
+void TurnProfiler::beginTurn() {
+    turn_start = mark = Clock::now();
+}
+
+void TurnProfiler::lap(ProfilePhase phase) {
+    Clock::time_point now = Clock::now();
+    turn_totals[phase] += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - mark).count());
+    touched |= 1u << phase;
+    mark = now;
+}
+
+void TurnProfiler::skip() {
+    mark = Clock::now();
+}
+
+void TurnProfiler::endTurn() {
+    uint64_t total = 0;
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        if (!(touched & (1u << i))) continue;
+        phases[i].record(turn_totals[i]);
+        total += turn_totals[i];
+        turn_totals[i] = 0;
+    }
+    touched = 0;
+    turns.record(total);
+}
+
+void TurnProfiler::merge(const TurnProfiler& other) {
+    for (int i = 0; i < PHASE_COUNT; i++) phases[i].merge(other.phases[i]);
+    turns.merge(other.turns);
+}
+
+static void printRow(std::stringstream& ss, const char* name, const LatencyHistogram& histogram) {
+    const double us = 1000.0;
+    ss << std::left << std::setw(12) << name << std::right
+       << std::setw(10) << histogram.getPercentile(0.50) / us
+       << std::setw(10) << histogram.getPercentile(0.90) / us
+       << std::setw(10) << histogram.getPercentile(0.99) / us
+       << std::setw(10) << histogram.getMax() / us << "\n";
+}
+
+std::string TurnProfiler::getSummary() const {
+    std::stringstream ss;
+    ss << "=== Turn Profile (" << turns.getCount() << " turns, microseconds) ===\n";
+    ss << std::left << std::setw(12) << "phase" << std::right
+       << std::setw(10) << "p50" << std::setw(10) << "p90"
+       << std::setw(10) << "p99" << std::setw(10) << "max" << "\n";
+    ss << std::fixed << std::setprecision(2);
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        if (phases[i].getCount() > 0) printRow(ss, phaseName(i), phases[i]);
+    }
+    printRow(ss, "turn", turns);
+    ss << "=================================================";
+    return ss.str();
+}
@@ -0,0 +1,78 @@
+// turn_profiler.h
+
+#ifndef TURN_PROFILER_H
+#define TURN_PROFILER_H
+
+#include <string>
+#include <chrono>
+#include <cstdint>
+
+enum ProfilePhase {
+    PHASE_DECIDE,      // getting a move: keyboard, script, replay or AI
+    PHASE_MOVE,        // applying the moves
+    PHASE_BULLETS,     // processBulletMovement
+    PHASE_COLLISIONS,  // processCollisions
+    PHASE_MAP_DAMAGE,  // processOutOfMapDamage
+    PHASE_LOGGING,     // turn-end event, replay, spectator, shared memory, checkpoint
+    PHASE_RENDER,      // drawing the board and turn banners
+    PHASE_COUNT
+};
+
+// Fixed log-linear buckets over nanoseconds: exact below 16 ns, then eight
+// buckets per power of two, so a percentile is off by at most 12.5%.
+// Recording is a few integer operations and never allocates.
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKETS = 8;
+    static const int BUCKET_COUNT = 16 + (64 - 4) * SUB_BUCKETS;
+
+private:
+    uint64_t buckets[BUCKET_COUNT];
+    uint64_t count;
+    uint64_t max_value;
+
+public:
+    LatencyHistogram();
+
+    void record(uint64_t nanoseconds);
+    void merge(const LatencyHistogram& other);
+
+    uint64_t getCount() const { return count; }
+    uint64_t getMax() const { return max_value; }
+    // upper bound of the bucket holding the given fraction (0-1] of samples
+    uint64_t getPercentile(double fraction) const;
+
+private:
+    static int bucketOf(uint64_t value);
+    static uint64_t bucketLimit(int bucket);
+};
+
+// --profile: wall time of each phase of GameEngine::gameLoop, summed per turn
+// and recorded into one histogram per phase when the turn ends.
+class TurnProfiler {
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    LatencyHistogram phases[PHASE_COUNT];
+    LatencyHistogram turns;
+    uint64_t turn_totals[PHASE_COUNT];
+    unsigned touched; // bit per phase that ran this turn
+    Clock::time_point turn_start;
+    Clock::time_point mark;
+
+public:
+    TurnProfiler();
+
+    void beginTurn();
+    // charges the time since the previous mark to phase
+    void lap(ProfilePhase phase);
+    // drops the time since the previous mark (pacing sleeps)
+    void skip();
+    void endTurn();
+
+    void merge(const TurnProfiler& other);
+    uint64_t getTurns() const { return turns.getCount(); }
+    std::string getSummary() const;
+};
+
+#endif // TURN_PROFILER_H
@@ -1,48 +1,107 @@
 // ui_manager.cpp
 
 #include "ui_manager.h"
-#include "game_engine.h"
+#include "game_core.h"
 #include "tank.h"
 #include "bullet.h"
 #include "game_map.h"
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <algorithm>
+#include <cstdio>
 
-UIManager::UIManager(bool detailed) : show_detailed_output(detailed) {
+#ifndef _WIN32
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
+
+UIManager::UIManager(bool detailed) : show_detailed_output(detailed), echo_input(!isatty(fileno(stdin))) {
 }
 
 UIManager::~UIManager() {}
 
-void UIManager::printGameMap(const GameEngine& game) const {
-    const GameMap& map = game.getGameMap();
-    const Tank& tank_a = game.getTankA();
-    const Tank& tank_b = game.getTankB();
-    // const auto& bullets = game.getBullets();
-    
-    int map_size = map.getCurrentSize();
-    // int center = map_size / 2;
+void UIManager::printGameMap(const GameCore& game) const {
+    game.captureSnapshot(frame_snapshot);
+    printMapFrame(frame_snapshot);
+}
+
+void UIManager::printMapFrame(const GameSnapshot& snapshot) const {
+    composeMapFrame(snapshot, frame_buffer);
     
-    std::cout << "A: " << tank_a.getLifePoints() 
-              << ", B: " << tank_b.getLifePoints() 
-              << ", Turn: " << game.getCurrentTurn() << std::endl;
+    // the whole frame in one write instead of a flush per row
+    std::cout.write(frame_buffer.data(), static_cast<std::streamsize>(frame_buffer.size()));
+    std::cout.flush();
+}
 
-    printMapBorder(map_size);
+void UIManager::composeMapFrame(const GameSnapshot& snapshot, std::string& out, bool full_view) const {
+    int view_size = rasterizeMap(snapshot, full_view);
+    int border_length = view_size * 2 + 2;
+    
+    out.clear();
+    out.reserve(32 + (border_length + 1) * (view_size + 2));
     
-    // print map contents
-    for (int y = map.getMinY() - 3; y <= map.getMaxY() + 3; y++) {
-        std::cout << "|";
-        for (int x = map.getMinX() - 3; x <= map.getMaxX() + 3; x++) {
-            char cell = getMapCell(game, x, y);
-            std::cout << cell << "|";
+    out += "A: ";
+    appendInt(out, snapshot.tank_a.life_points);
+    out += ", B: ";
+    appendInt(out, snapshot.tank_b.life_points);
+    out += ", Turn: ";
+    appendInt(out, snapshot.current_turn);
+    out += '\n';
+    
+    out.append(border_length, '-');
+    out += '\n';
+    for (int row = 0; row < view_size; row++) {
+        const char* cells = &frame_cells[row * view_size];
+        out += '|';
+        for (int col = 0; col < view_size; col++) {
+            out += cells[col];
+            out += '|';
         }
-        std::cout << std::endl;
+        out += '\n';
+    }
+    out.append(border_length, '-');
+    out += '\n';
+}
+
+// Draws the map plus three cells of margin on every side into frame_cells,
+// one pass over the cells and one over the bullets. returns the side length.
+int UIManager::rasterizeMap(const GameSnapshot& snapshot, bool full_view) const {
+    const int margin = 3;
+    int view_map_size = full_view ? INITIAL_MAP_SIZE : snapshot.map_size;
+    int view_size = view_map_size + margin * 2;
+    int origin = INITIAL_MAP_SIZE / 2 - view_map_size / 2 - margin;
+    int inner = INITIAL_MAP_SIZE / 2 - snapshot.map_size / 2 - origin;
+    
+    frame_cells.assign(view_size * view_size, '-');
+    for (int row = inner; row < inner + snapshot.map_size; row++) {
+        std::fill_n(&frame_cells[row * view_size + inner], snapshot.map_size, ' ');
+    }
+    
+    // walk backwards so that the first bullet on a cell wins, as before
+    for (size_t i = snapshot.bullets.size(); i-- > 0; ) {
+        const BulletSnapshot& bullet = snapshot.bullets[i];
+        int col = bullet.x - origin;
+        int row = bullet.y - origin;
+        if (!bullet.active || col < 0 || col >= view_size || row < 0 || row >= view_size) continue;
+        frame_cells[row * view_size + col] = getBulletDirectionChar(bullet.direction);
     }
     
-    printMapBorder(map_size);
+    // tanks are drawn over bullets, A over B
+    const TankSnapshot* tanks[2] = {&snapshot.tank_b, &snapshot.tank_a};
+    const char ids[2] = {'B', 'A'};
+    for (int i = 0; i < 2; i++) {
+        int col = tanks[i]->x - origin;
+        int row = tanks[i]->y - origin;
+        if (col < 0 || col >= view_size || row < 0 || row >= view_size) continue;
+        frame_cells[row * view_size + col] = getDirectionChar(ids[i], tanks[i]->direction);
+    }
+    
+    return view_size;
 }
 
-void UIManager::printGameStatus(const GameEngine& game) const {
+void UIManager::printGameStatus(const GameCore& game) const {
     const Tank& tank_a = game.getTankA();
     const Tank& tank_b = game.getTankB();
     
@@ -113,11 +172,17 @@ Move UIManager::getPlayerInput(char tank_id) const {
     
     int input;
     while (!(std::cin >> input) || input < 0 || input > 2) {
+        if (std::cin.eof()) {
+            std::cout << std::endl;
+            printError("Input closed, moving forward");
+            return M_Forward;
+        }
         std::cout << "Invalid input! Please enter 0, 1, or 2: ";
         std::cin.clear();
         std::cin.ignore(10000, '\n');
     }
     
+    if (echo_input) std::cout << input << std::endl;
     return static_cast<Move>(input);
 }
 
@@ -168,14 +233,8 @@ void UIManager::clearScreen() const {
     std::cout << "\033[2J\033[1;1H";
 }
 
-std::string UIManager::directionToString(Direction dir) const {
-    switch (dir) {
-        case D_Left:  return "Left";
-        case D_Up:    return "Up";
-        case D_Right: return "Right";
-        case D_Down:  return "Down";
-        default:      return "Unknown";
-    }
+const char* UIManager::directionToString(Direction dir) const {
+    return directionName(dir);
 }
 
 std::string UIManager::moveToString(Move move) const {
@@ -204,7 +263,7 @@ void UIManager::printMapBorder(int map_size) const {
     std::cout << std::endl;
 }
 
-char UIManager::getMapCell(const GameEngine& game, int x, int y) const {
+char UIManager::getMapCell(const GameCore& game, int x, int y) const {
     const Tank& tank_a = game.getTankA();
     const Tank& tank_b = game.getTankB();
     const auto& bullets = game.getBullets();
@@ -220,8 +279,8 @@ char UIManager::getMapCell(const GameEngine& game, int x, int y) const {
     
     // Show bullets with direction indicators
     for (const auto& bullet : bullets) {
-        if (bullet->isActive() && bullet->isAtPosition(x, y)) {
-            return getBulletDirectionChar(bullet->getDirection());
+        if (bullet.isActive() && bullet.isAtPosition(x, y)) {
+            return getBulletDirectionChar(bullet.getDirection());
         }
     }
 
@@ -261,7 +320,7 @@ char UIManager::getBulletDirectionChar(Direction dir) const {
     return '*';
 }
 
-void UIManager::printMapRow(const GameEngine& game, int row) const {
+void UIManager::printMapRow(const GameCore& game, int row) const {
     const GameMap& map = game.getGameMap();
     int min_x = map.getMinX() - 3; 
     int max_x = map.getMaxX() + 3;
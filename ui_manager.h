@@ -6,23 +6,33 @@
 #include <string>
 #include <vector>
 #include "common.h"
+#include "game_snapshot.h"
 
-class GameEngine; 
+class GameCore;
 class Tank;
 class Bullet;
 
 class UIManager {
 private:
     bool show_detailed_output;
+    bool echo_input; // input piped in: nothing ends the prompt's line, so print the move
     std::string last_output;
+    
+    // reused for every frame so that drawing does not allocate
+    mutable GameSnapshot frame_snapshot;
+    mutable std::vector<char> frame_cells;
+    mutable std::string frame_buffer;
 
 public:
     UIManager(bool detailed = true);
     ~UIManager();
     
     // regular
-    void printGameMap(const GameEngine& game) const;
-    void printGameStatus(const GameEngine& game) const;
+    void printGameMap(const GameCore& game) const;
+    void printMapFrame(const GameSnapshot& snapshot) const;
+    // full_view keeps the frame at the initial map size so it does not move as the map shrinks
+    void composeMapFrame(const GameSnapshot& snapshot, std::string& out, bool full_view = false) const;
+    void printGameStatus(const GameCore& game) const;
     void printTurnInfo(int turn, char current_player) const;
     void printGameResult(GameResult result) const;
     
@@ -45,14 +55,15 @@ public:
     void setDetailedOutput(bool detailed) { show_detailed_output = detailed; }
     bool isDetailedOutput() const { return show_detailed_output; }
     
-    std::string directionToString(Direction dir) const;
+    const char* directionToString(Direction dir) const;
     std::string moveToString(Move move) const;
     std::string gameModeToString(GameMode mode) const;
     
 private:
     void printMapBorder(int map_size) const;
-    void printMapRow(const GameEngine& game, int row) const;
-    char getMapCell(const GameEngine& game, int x, int y) const;
+    void printMapRow(const GameCore& game, int row) const;
+    int rasterizeMap(const GameSnapshot& snapshot, bool full_view) const;
+    char getMapCell(const GameCore& game, int x, int y) const;
     char getDirectionChar(char tank_id, Direction dir) const;
     char getBulletDirectionChar(Direction dir) const;
     bool isValidInput(const std::string& input) const;
@@ -0,0 +1,66 @@
+// worker_pool.cpp
+
+#include "worker_pool.h"
+
+WorkerPool::WorkerPool(int threads)
+    : job(nullptr), task_count(0), batch(0), busy(0), stopping(false), next_task(0) {
+    for (int i = 1; i < threads; i++) {
+        workers.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) worker.join();
+}
+
+void WorkerPool::run(Job& new_job, int tasks) {
+    if (workers.empty()) {
+        for (int task = 0; task < tasks; task++) new_job.runTask(task);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &new_job;
+        task_count = tasks;
+        next_task.store(0);
+        busy = static_cast<int>(workers.size());
+        batch++;
+    }
+    wake.notify_all();
+    work(new_job, tasks);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return busy == 0; });
+    job = nullptr;
+}
+
+void WorkerPool::workerLoop() {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this, seen] { return stopping || batch != seen; });
+        if (stopping) return;
+        seen = batch;
+        Job* current = job;
+        int tasks = task_count;
+
+        lock.unlock();
+        work(*current, tasks);
+        lock.lock();
+        if (--busy == 0) done.notify_one();
+    }
+}
+
+void WorkerPool::work(Job& current, int tasks) {
+    for (;;) {
+        int task = next_task.fetch_add(1);
+        if (task >= tasks) return;
+        current.runTask(task);
+    }
+}
@@ -0,0 +1,56 @@
+// worker_pool.h
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+
+// A fixed set of threads kept for the life of the AI, so a search can fan out
+// every move without starting threads. run() hands out the tasks of a job
+// one at a time to whichever thread is free, the caller included, and
+// returns when all are done. Which thread runs a task is left to chance, so a
+// job that must be deterministic gives each task its own state.
+class WorkerPool {
+public:
+    class Job {
+    public:
+        virtual ~Job() {}
+        virtual void runTask(int task) = 0;
+    };
+
+private:
+    std::vector<std::thread> workers; // threads - 1: the caller is the last one
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    Job* job;            // guarded by mutex
+    int task_count;      // guarded by mutex
+    uint64_t batch;      // guarded by mutex, counts run() calls
+    int busy;            // guarded by mutex, workers still on the batch
+    bool stopping;       // guarded by mutex
+    std::atomic<int> next_task;
+
+public:
+    explicit WorkerPool(int threads);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    int getThreads() const { return static_cast<int>(workers.size()) + 1; }
+
+    // runs job.runTask(0 .. tasks - 1) and waits for all of them
+    void run(Job& job, int tasks);
+
+private:
+    void workerLoop();
+    void work(Job& job, int tasks);
+};
+
+#endif // WORKER_POOL_H